@@ -0,0 +1,23 @@
+# libmdbx:
+# https://gitflic.ru/project/erthink/libmdbx/blob?file=CMakeLists.txt
+
+include(FetchContent)
+FetchContent_Declare(
+    mdbx
+    # The amalgamated release carries the version info, which a plain git checkout lacks
+    URL https://libmdbx.dqdkfa.ru/release/libmdbx-amalgamated-0.12.10.tar.xz
+)
+
+FetchContent_GetProperties(mdbx)
+
+if(NOT mdbx_POPULATED)
+    set(MDBX_BUILD_SHARED_LIBRARY OFF CACHE INTERNAL "")
+    set(MDBX_BUILD_TOOLS OFF CACHE INTERNAL "")
+    set(MDBX_BUILD_CXX OFF CACHE INTERNAL "")
+    set(MDBX_INSTALL_STATIC OFF CACHE INTERNAL "")
+
+    FetchContent_Populate(mdbx)
+    add_subdirectory(${mdbx_SOURCE_DIR} ${mdbx_BINARY_DIR} EXCLUDE_FROM_ALL)
+endif()
+
+include_directories(${mdbx_SOURCE_DIR})
@@ -12,7 +12,12 @@ FetchContent_Declare(
 FetchContent_GetProperties(rocksdb)
 
 if(NOT rocksdb_POPULATED)
-    set(WITH_LIBURING OFF CACHE INTERNAL "")
+    # Parallel block reads of `MultiGet` within a file go through `io_uring`
+    if(${UCSB_ROCKSDB_WITH_LIBURING})
+        set(WITH_LIBURING ON CACHE INTERNAL "")
+    else()
+        set(WITH_LIBURING OFF CACHE INTERNAL "")
+    endif()
     set(WITH_SNAPPY OFF CACHE INTERNAL "")
     set(WITH_LZ4 OFF CACHE INTERNAL "")
     set(WITH_GFLAGS OFF CACHE INTERNAL "")
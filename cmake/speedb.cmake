@@ -0,0 +1,61 @@
+# Speedb:
+# https://github.com/speedb-io/speedb/blob/main/CMakeLists.txt
+#
+# Built as an external project, as the flags below must not leak into RocksDB and UCSB itself.
+# A custom `ROCKSDB_NAMESPACE` keeps its C++ symbols apart from RocksDB, and `XXH_NAMESPACE`
+# does the same for the bundled xxHash.
+
+set(PREFIX_DIR ${CMAKE_BINARY_DIR}/_deps)
+
+include(ExternalProject)
+
+ExternalProject_Add(
+    speedb_external
+
+    GIT_REPOSITORY "https://github.com/speedb-io/speedb.git"
+    GIT_TAG speedb/v2.8.0
+    GIT_SHALLOW 1
+    GIT_PROGRESS 0
+
+    PREFIX "${PREFIX_DIR}"
+    DOWNLOAD_DIR "${PREFIX_DIR}/speedb-src"
+    LOG_DIR "${PREFIX_DIR}/speedb-log"
+    STAMP_DIR "${PREFIX_DIR}/speedb-stamp"
+    TMP_DIR "${PREFIX_DIR}/speedb-tmp"
+    SOURCE_DIR "${PREFIX_DIR}/speedb-src"
+    INSTALL_DIR "${PREFIX_DIR}/speedb-install"
+    BINARY_DIR "${PREFIX_DIR}/speedb-build"
+
+    CMAKE_ARGS
+        -DCMAKE_BUILD_TYPE=Release
+        "-DCMAKE_CXX_FLAGS=-DROCKSDB_NAMESPACE=speedb -DXXH_NAMESPACE=SPEEDB_XXH -Wno-implicit-fallthrough"
+        -DWITH_LIBURING=${UCSB_ROCKSDB_WITH_LIBURING}
+        -DWITH_SNAPPY=OFF
+        -DWITH_LZ4=OFF
+        -DWITH_GFLAGS=OFF
+        -DWITH_JEMALLOC=OFF
+        -DFAIL_ON_WARNINGS=OFF
+        -DUSE_RTTI=1
+        -DPORTABLE=ON
+        -DWITH_JNI=OFF
+        -DWITH_CORE_TOOLS=OFF
+        -DWITH_TOOLS=OFF
+        -DWITH_TESTS=OFF
+        -DWITH_BENCHMARK_TOOLS=OFF
+    UPDATE_COMMAND ""
+    INSTALL_COMMAND ""
+    BUILD_ALWAYS 0
+
+    BUILD_COMMAND ${CMAKE_COMMAND} --build . --target speedb
+)
+
+set(speedb_INCLUDE_DIR ${PREFIX_DIR}/speedb-src/include)
+set(speedb_LIBRARY_PATH ${PREFIX_DIR}/speedb-build/libspeedb.a)
+
+file(MAKE_DIRECTORY ${speedb_INCLUDE_DIR})
+add_library(speedb STATIC IMPORTED)
+
+set_property(TARGET speedb PROPERTY IMPORTED_LOCATION ${speedb_LIBRARY_PATH})
+add_dependencies(speedb speedb_external)
+
+# Unlike other DBs, headers are not added globally, as they shadow the RocksDB ones
@@ -0,0 +1,48 @@
+# splinterdb:
+# https://github.com/vmware/splinterdb/blob/main/Makefile
+
+# The adapter needs `splinterdb_close(splinterdb**)`, the 4-argument `splinterdb_lookup_result_init`
+# and `splinterdb_iterator_status`. Override the pin with `-DSPLINTERDB_GIT_TAG=<sha>` to build another revision.
+set(SPLINTERDB_GIT_TAG "v0.0.1" CACHE STRING "SplinterDB tag or commit to build the benchmark against")
+
+set(PREFIX_DIR ${CMAKE_BINARY_DIR}/_deps)
+
+include(ExternalProject)
+
+ExternalProject_Add(
+    splinterdb_external
+
+    GIT_REPOSITORY "https://github.com/vmware/splinterdb.git"
+    GIT_TAG "${SPLINTERDB_GIT_TAG}"
+    GIT_PROGRESS 0
+
+    PREFIX "${PREFIX_DIR}"
+    DOWNLOAD_DIR "${PREFIX_DIR}/splinterdb-src"
+    LOG_DIR "${PREFIX_DIR}/splinterdb-log"
+    STAMP_DIR "${PREFIX_DIR}/splinterdb-stamp"
+    TMP_DIR "${PREFIX_DIR}/splinterdb-tmp"
+    SOURCE_DIR "${PREFIX_DIR}/splinterdb-src"
+    INSTALL_DIR "${PREFIX_DIR}/splinterdb-install"
+    BINARY_DIR "${PREFIX_DIR}/splinterdb-src"
+
+    CONFIGURE_COMMAND ""
+    UPDATE_COMMAND ""
+    INSTALL_COMMAND ""
+    BUILD_ALWAYS 0
+
+    # Needs `libaio` and `libxxhash` in the system
+    BUILD_COMMAND make BUILD_MODE=release libs
+)
+
+set(splinterdb_INCLUDE_DIR ${PREFIX_DIR}/splinterdb-src/include)
+set(splinterdb_LIBRARY_PATH ${PREFIX_DIR}/splinterdb-src/build/release/lib/libsplinterdb.a)
+
+file(MAKE_DIRECTORY ${splinterdb_INCLUDE_DIR})
+add_library(splinterdb STATIC IMPORTED)
+
+set_property(TARGET splinterdb PROPERTY IMPORTED_LOCATION ${splinterdb_LIBRARY_PATH})
+set_property(TARGET splinterdb APPEND PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${splinterdb_INCLUDE_DIR})
+set_property(TARGET splinterdb APPEND PROPERTY INTERFACE_LINK_LIBRARIES aio xxhash)
+
+include_directories(${splinterdb_INCLUDE_DIR})
+add_dependencies(splinterdb splinterdb_external)
@@ -0,0 +1,21 @@
+# sqlite:
+# https://www.sqlite.org/amalgamation.html
+
+include(FetchContent)
+FetchContent_Declare(
+    sqlite
+    URL https://www.sqlite.org/2024/sqlite-amalgamation-3450300.zip
+)
+
+FetchContent_GetProperties(sqlite)
+
+if(NOT sqlite_POPULATED)
+    FetchContent_Populate(sqlite)
+endif()
+
+# The amalgamation has no build system of its own
+add_library(sqlite3 STATIC ${sqlite_SOURCE_DIR}/sqlite3.c)
+target_compile_definitions(sqlite3 PRIVATE SQLITE_THREADSAFE=2 SQLITE_DEFAULT_MEMSTATUS=0 SQLITE_OMIT_LOAD_EXTENSION=1)
+target_include_directories(sqlite3 PUBLIC ${sqlite_SOURCE_DIR})
+
+include_directories(${sqlite_SOURCE_DIR})
@@ -0,0 +1,43 @@
+# tkrzw:
+# https://github.com/estraier/tkrzw/blob/master/configure.in
+
+set(PREFIX_DIR ${CMAKE_BINARY_DIR}/_deps)
+
+include(ExternalProject)
+
+ExternalProject_Add(
+    tkrzw_external
+
+    GIT_REPOSITORY "https://github.com/estraier/tkrzw.git"
+    GIT_TAG 1.0.27
+    GIT_SHALLOW 1
+    GIT_PROGRESS 0
+
+    PREFIX "${PREFIX_DIR}"
+    DOWNLOAD_DIR "${PREFIX_DIR}/tkrzw-src"
+    LOG_DIR "${PREFIX_DIR}/tkrzw-log"
+    STAMP_DIR "${PREFIX_DIR}/tkrzw-stamp"
+    TMP_DIR "${PREFIX_DIR}/tkrzw-tmp"
+    SOURCE_DIR "${PREFIX_DIR}/tkrzw-src"
+    INSTALL_DIR "${PREFIX_DIR}/tkrzw-install"
+    BINARY_DIR "${PREFIX_DIR}/tkrzw-src"
+
+    CONFIGURE_COMMAND ./configure --prefix=${PREFIX_DIR}/tkrzw-install --enable-opt-native --disable-zlib --disable-zstd --disable-lz4 --disable-lzma
+    UPDATE_COMMAND ""
+    INSTALL_COMMAND ""
+    BUILD_ALWAYS 0
+
+    BUILD_COMMAND make libtkrzw.a
+)
+
+set(tkrzw_INCLUDE_DIR ${PREFIX_DIR}/tkrzw-src)
+set(tkrzw_LIBRARY_PATH ${PREFIX_DIR}/tkrzw-src/libtkrzw.a)
+
+file(MAKE_DIRECTORY ${tkrzw_INCLUDE_DIR})
+add_library(tkrzw STATIC IMPORTED)
+
+set_property(TARGET tkrzw PROPERTY IMPORTED_LOCATION ${tkrzw_LIBRARY_PATH})
+set_property(TARGET tkrzw APPEND PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${tkrzw_INCLUDE_DIR})
+
+include_directories(${tkrzw_INCLUDE_DIR})
+add_dependencies(tkrzw tkrzw_external)
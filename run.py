@@ -20,11 +20,18 @@ Note there are some databases and sizes commented by default just to minimize th
 db_names = [
     "ustore",
     "rocksdb",
+    # "speedb",
     "leveldb",
     "wiredtiger",
     # "mongodb",
     # "redis",
     # "lmdb",
+    # "mdbx",
+    # "sqlite",
+    # "tkrzw",
+    # "splinterdb",
+    # "memory_hash",
+    # "memory_btree",
 ]
 
 sizes = [
@@ -49,7 +56,10 @@ workload_names = [
 ]
 
 threads_count = 1
+reader_processes_count = 0
+primary_writes_only = False
 transactional = False
+calibrate = False
 
 drop_caches = False
 run_in_docker_container = False
@@ -137,6 +147,9 @@ def run(
     drop_caches: bool,
     run_in_docker_container: bool,
     threads_count: bool,
+    reader_processes_count: int,
+    primary_writes_only: bool,
+    calibrate: bool,
     run_index: int,
     runs_count: int,
 ) -> None:
@@ -149,6 +162,8 @@ def run(
     )
 
     transactional_flag = "-t" if transactional else ""
+    calibrate_flag = "-cal" if calibrate else ""
+    primary_writes_only_flag = "-pw" if primary_writes_only else ""
     filter = ",".join(workload_names)
     db_storage_dir_paths = ",".join(db_storage_dir_paths)
 
@@ -161,7 +176,7 @@ def run(
             raise Exception("First, please build the runner: `build_release.sh`")
 
     process = pexpect.spawn(
-        f'{runner} -db {db_name} {transactional_flag} -cfg "{db_config_file_path}" -wl "{workloads_file_path}" -md "{db_main_dir_path}" -sd "{db_storage_dir_paths}" -res "{results_file_path}" -th {threads_count} -fl {filter} -ri {run_index} -rc {runs_count}'
+        f'{runner} -db {db_name} {transactional_flag} -cfg "{db_config_file_path}" -wl "{workloads_file_path}" -md "{db_main_dir_path}" -sd "{db_storage_dir_paths}" -res "{results_file_path}" -th {threads_count} -rp {reader_processes_count} {primary_writes_only_flag} -fl {filter} -ri {run_index} -rc {runs_count} {calibrate_flag}'
     )
     process.interact()
     process.close()
@@ -185,7 +200,10 @@ def parse_args():
     global main_dir_path
     global storage_disk_paths
     global threads_count
+    global reader_processes_count
+    global primary_writes_only
     global transactional
+    global calibrate
     global drop_caches
     global run_in_docker_container
 
@@ -239,6 +257,21 @@ def parse_args():
         required=False,
         default=threads_count,
     )
+    parser.add_argument(
+        "-rp",
+        "--reader-processes",
+        help="Sibling processes count, running reads on the same DB (multi-process engines only)",
+        type=int,
+        required=False,
+        default=reader_processes_count,
+    )
+    parser.add_argument(
+        "-pw",
+        "--primary-writes-only",
+        help="Leaves the reads of the whole workload to the reader processes, running only the writes in the main one",
+        action=argparse.BooleanOptionalAction,
+        default=primary_writes_only,
+    )
     parser.add_argument(
         "-tx",
         "--transactional",
@@ -246,6 +279,13 @@ def parse_args():
         action=argparse.BooleanOptionalAction,
         default=transactional,
     )
+    parser.add_argument(
+        "-cal",
+        "--calibrate",
+        help="Measures own costs of the benchmark against the null engine, before each run",
+        action=argparse.BooleanOptionalAction,
+        default=calibrate,
+    )
     parser.add_argument(
         "-dp",
         "--drop-caches",
@@ -268,7 +308,10 @@ def parse_args():
     main_dir_path = args.main_dir
     storage_disk_paths = args.storage_dirs
     threads_count = args.threads
+    reader_processes_count = args.reader_processes
+    primary_writes_only = args.primary_writes_only
     transactional = args.transactional
+    calibrate = args.calibrate
     drop_caches = args.drop_caches
     run_in_docker_container = args.run_docker
 
@@ -353,6 +396,9 @@ def main() -> None:
                         drop_caches,
                         run_in_docker_container,
                         threads_count,
+                        reader_processes_count,
+                        primary_writes_only,
+                        calibrate,
                         i,
                         len(workload_names),
                     )
@@ -367,6 +413,9 @@ def main() -> None:
                     drop_caches,
                     run_in_docker_container,
                     threads_count,
+                    reader_processes_count,
+                    primary_writes_only,
+                    calibrate,
                     0,
                     1,
                 )
@@ -26,6 +26,8 @@
 #include "src/core/printable.hpp"
 #include "src/core/reporter.hpp"
 #include "src/core/threads_fence.hpp"
+#include "src/core/reader_processes.hpp"
+#include "src/core/calibration.hpp"
 
 namespace bm = benchmark;
 using namespace ucsb;
@@ -45,9 +47,20 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
         .default_value(std::string(""))
         .help("Database storage directory paths");
     program.add_argument("-th", "--threads").default_value(std::string("1")).help("Threads count");
+    program.add_argument("-rp", "--reader-processes")
+        .default_value(std::string("0"))
+        .help("Sibling processes count, running reads on the same DB");
+    program.add_argument("-pw", "--primary-writes-only")
+        .default_value(false)
+        .implicit_value(true)
+        .help("Leave the reads of the whole workload to the reader processes, running only the writes in the main one");
     program.add_argument("-fl", "--filter").default_value(std::string("")).help("Workloads filter");
     program.add_argument("-ri", "--run-index").default_value(std::string("0")).help("Run index in sequence");
     program.add_argument("-rc", "--runs-count").default_value(std::string("1")).help("Total runs count");
+    program.add_argument("-cal", "--calibrate")
+        .default_value(false)
+        .implicit_value(true)
+        .help("Measure the own costs of the benchmark against the null engine first");
 
     program.parse_known_args(argc, argv);
 
@@ -57,9 +70,12 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
     settings.workloads_file_path = program.get("workload-path");
     settings.results_file_path = program.get("results-path");
     settings.threads_count = std::stoi(program.get("threads"));
+    settings.reader_processes_count = std::stoi(program.get("reader-processes"));
+    settings.primary_writes_only = program.get<bool>("primary-writes-only");
     settings.workload_filter = program.get("filter");
     settings.run_idx = std::stoi(program.get("run-index"));
     settings.runs_count = std::stoi(program.get("runs-count"));
+    settings.calibrate = program.get<bool>("calibrate");
 
     // Resolve paths
     auto path = program.get("main-dir");
@@ -81,6 +97,14 @@ void parse_and_validate_args(int argc, char* argv[], settings_t& settings) {
         fmt::print("Zero threads count specified\n");
         exit(1);
     }
+    if (settings.reader_processes_count != 0 && settings.transactional) {
+        fmt::print("Reader processes aren't supported in transactional mode\n");
+        exit(1);
+    }
+    if (settings.primary_writes_only && settings.reader_processes_count == 0) {
+        fmt::print("Writes only primary requires reader processes\n");
+        exit(1);
+    }
     if (settings.runs_count == 0) {
         fmt::print("Zero total runs count specified\n");
         exit(1);
@@ -110,6 +134,10 @@ std::string build_title(settings_t const& settings, workloads_t const& workloads
     }
 
     infos.push_back(fmt::format("Threads: {}", settings.threads_count));
+    if (settings.reader_processes_count)
+        infos.push_back(fmt::format("Reader processes: {}{}",
+                                    settings.reader_processes_count,
+                                    settings.primary_writes_only ? " (primary writes only)" : ""));
     infos.push_back(fmt::format("Disks: {}", std::max(size_t(1), settings.db_storage_dir_paths.size())));
 
     return fmt::format("{}", fmt::join(infos, " | "));
@@ -180,6 +208,10 @@ void validate_workload(workload_t const& workload, [[maybe_unused]] size_t threa
     proportion += workload.bulk_load_proportion;
     proportion += workload.range_select_proportion;
     proportion += workload.scan_proportion;
+    proportion += workload.doc_read_proportion;
+    proportion += workload.doc_patch_proportion;
+    proportion += workload.edge_upsert_proportion;
+    proportion += workload.neighbors_read_proportion;
     assert(proportion > 0.0 && proportion <= 1.0);
 
     assert(workload.value_length > 0);
@@ -282,12 +314,18 @@ operation_chooser_ptr_t create_operation_chooser(workload_t const& workload) {
     chooser->add(operation_kind_t::bulk_load_k, workload.bulk_load_proportion);
     chooser->add(operation_kind_t::range_select_k, workload.range_select_proportion);
     chooser->add(operation_kind_t::scan_k, workload.scan_proportion);
+    chooser->add(operation_kind_t::doc_read_k, workload.doc_read_proportion);
+    chooser->add(operation_kind_t::doc_patch_k, workload.doc_patch_proportion);
+    chooser->add(operation_kind_t::edge_upsert_k, workload.edge_upsert_proportion);
+    chooser->add(operation_kind_t::neighbors_read_k, workload.neighbors_read_proportion);
     return chooser;
 }
 
 struct progress_t {
     size_t entries_touched = 0;
     size_t bytes_processed = 0;
+    elapsed_time_t flush_elapsed_time = elapsed_time_t(0);
+    size_t threads_operations_ns = 0;
 
     size_t done_iterations = 0;
     size_t failed_iterations = 0;
@@ -371,6 +409,8 @@ struct progress_t {
     }
 
     void clear() {
+        flush_elapsed_time = elapsed_time_t(0);
+        threads_operations_ns = 0;
         failed_iterations = 0;
         entries_touched = 0;
         bytes_processed = 0;
@@ -381,7 +421,13 @@ struct progress_t {
     }
 };
 
-void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor_t& data_accessor) {
+void bench(bm::State& state,
+           workload_t const& workload,
+           db_t& db,
+           data_accessor_t& data_accessor,
+           workloads_t const& readers_workloads,
+           reader_processes_t& readers,
+           double harness_ns) {
 
     // Bench components
     auto chooser = create_operation_chooser(workload);
@@ -393,6 +439,7 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
     cpu_profiler_t cpu_prof;    // Only one thread profiles
     mem_profiler_t mem_prof;    // Only one thread profiles
     static progress_t progress; // Shared between threads
+    reader_processes_t::result_t readers_result;
 
     // Bench initialization
     atomic_add_fetch(progress.total_iterations, workload.operations_count);
@@ -400,6 +447,7 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
         cpu_prof.start();
         mem_prof.start();
         progress.print_start(workload.name);
+        readers.start(readers_workloads);
     }
 
     // Bench
@@ -421,6 +469,10 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
             case operation_kind_t::bulk_load_k: result = worker.do_bulk_load(); break;
             case operation_kind_t::range_select_k: result = worker.do_range_select(); break;
             case operation_kind_t::scan_k: result = worker.do_scan(); break;
+            case operation_kind_t::doc_read_k: result = worker.do_doc_read(); break;
+            case operation_kind_t::doc_patch_k: result = worker.do_doc_patch(); break;
+            case operation_kind_t::edge_upsert_k: result = worker.do_edge_upsert(); break;
+            case operation_kind_t::neighbors_read_k: result = worker.do_neighbors_read(); break;
             default: throw exception_t("Unknown operation"); break;
             }
 
@@ -440,11 +492,23 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
             bool is_last_iteration = done_iterations == progress.total_iterations;
             if (is_last_iteration && do_flash.compare_exchange_weak(only_once, false)) {
                 progress_t::print_db_flush();
+                auto flush_start_time = high_resolution_clock_t::now();
                 db.flush();
+                progress.flush_elapsed_time = high_resolution_clock_t::now() - flush_start_time;
             }
 
             --thread_iterations;
         }
+
+        // Every thread is accounted before the barrier at the end of the batch
+        atomic_add_fetch(progress.threads_operations_ns, size_t(timer.operations_elapsed_time().count()));
+
+        // Readers run concurrently, so their time is accounted into this benchmark
+        if (state.thread_index() == 0) {
+            readers_result = readers.wait();
+            atomic_add_fetch(progress.entries_touched, readers_result.entries_touched);
+            atomic_add_fetch(progress.bytes_processed, readers_result.bytes_processed);
+        }
     }
     timer.stop();
 
@@ -468,6 +532,32 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
         state.counters["mem_avg(vm),bytes"] = bm::Counter(mem_prof.vm().avg, bm::Counter::kDefaults, bm::Counter::kIs1024);
         state.counters["processed,bytes"] = bm::Counter(progress.bytes_processed, bm::Counter::kDefaults, bm::Counter::kIs1024);
         state.counters["disk,bytes"] = bm::Counter(db.size_on_disk(), bm::Counter::kDefaults, bm::Counter::kIs1024);
+        state.counters["flush,ms"] = bm::Counter(std::chrono::duration<double, std::milli>(progress.flush_elapsed_time).count());
+        if (readers_result.processes_count) {
+            state.counters["reader_processes"] = bm::Counter(readers_result.processes_count);
+            state.counters["readers_operations/s"] = bm::Counter(readers_result.operations_per_second);
+            state.counters["readers_fails,%"] = bm::Counter(readers_result.failed_iterations * 100.0 / readers_result.done_iterations);
+            for (size_t idx = 0; idx != readers_result.processes.size(); ++idx) {
+                auto const& process = readers_result.processes[idx];
+                std::string prefix = fmt::format("reader[{}]_", idx);
+                state.counters[prefix + "operations/s"] = bm::Counter(process.operations_per_second);
+                for (auto const& [name, value] : process.counters)
+                    state.counters[prefix + name] = bm::Counter(value);
+            }
+        }
+        for (auto const& [name, value] : db.counters())
+            state.counters[name] = bm::Counter(value);
+
+        // Own costs of the benchmark are subtracted from the time of every thread, and threads run in parallel,
+        // so entries of this process are divided by the mean of their net times
+        if (harness_ns > 0) {
+            double seconds = progress.threads_operations_ns / 1e9;
+            double net_seconds = seconds - state.threads() * workload.operations_count * harness_ns / 1e9;
+            state.counters["harness,ns/op"] = bm::Counter(harness_ns);
+            size_t threads_entries_touched = progress.entries_touched - readers_result.entries_touched;
+            if (net_seconds > 0)
+                state.counters["net_operations/s"] = bm::Counter(threads_entries_touched * state.threads() / net_seconds);
+        }
 
         progress.clear();
     }
@@ -475,7 +565,14 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, data_accessor
     // clang-format on
 }
 
-void bench(bm::State& state, workload_t const& workload, db_t& db, bool transactional, threads_fence_t& fence) {
+void bench(bm::State& state,
+           workload_t const& workload,
+           db_t& db,
+           bool transactional,
+           workloads_t const& readers_workloads,
+           reader_processes_t& readers,
+           threads_fence_t& fence,
+           double harness_ns) {
 
     if (state.thread_index() == 0) {
         progress_t::print_db_open();
@@ -489,10 +586,10 @@ void bench(bm::State& state, workload_t const& workload, db_t& db, bool transact
         auto transaction = db.create_transaction();
         if (!transaction)
             throw exception_t("Failed to create DB transaction");
-        bench(state, workload, db, *transaction);
+        bench(state, workload, db, *transaction, readers_workloads, readers, harness_ns);
     }
     else
-        bench(state, workload, db, db);
+        bench(state, workload, db, db, readers_workloads, readers, harness_ns);
 
     fence.sync();
     if (state.thread_index() == 0) {
@@ -565,10 +662,19 @@ int main(int argc, char** argv) {
             return 1;
         }
         std::vector<workloads_t> threads_workloads;
+        std::vector<workloads_t> readers_workloads;
         for (auto const& workload : workloads) {
             validate_workload(workload, settings.threads_count);
             std::vector<workload_t> splitted_workloads = split_workload_into_threads(workload, settings.threads_count);
             threads_workloads.push_back(splitted_workloads);
+
+            // Readers split the whole workload between themselves, just like threads do
+            if (settings.reader_processes_count) {
+                validate_workload(workload, settings.reader_processes_count);
+                readers_workloads.push_back(split_workload_into_threads(workload, settings.reader_processes_count));
+            }
+            else
+                readers_workloads.emplace_back();
         }
 
         // Setup DB
@@ -582,13 +688,52 @@ int main(int argc, char** argv) {
         db->set_config(settings.db_config_file_path, settings.db_main_dir_path, settings.db_storage_dir_paths, hints);
 
         threads_fence_t fence(settings.threads_count);
+        reader_processes_t readers(settings.reader_processes_count, [&](size_t process_idx) {
+            std::shared_ptr<db_t> reader_db = make_db(db_brand, settings.transactional);
+            db_hints_t reader_hints = hints;
+            reader_hints.read_replica = true;
+            reader_hints.replica_idx = process_idx;
+            if (reader_db)
+                reader_db->set_config(settings.db_config_file_path,
+                                      settings.db_main_dir_path,
+                                      settings.db_storage_dir_paths,
+                                      reader_hints);
+            return reader_db;
+        });
+
+        // Calibrate on the share of a single thread, which is what every thread replays
+        std::vector<double> harness_costs(threads_workloads.size(), 0);
+        if (settings.calibrate) {
+            calibrator_t calibrator;
+            for (size_t idx = 0; idx != threads_workloads.size(); ++idx) {
+                auto workload = threads_workloads[idx].front();
+                if (settings.primary_writes_only)
+                    workload = write_part(workload);
+                auto chooser = create_operation_chooser(workload);
+                harness_costs_t costs = calibrator.calibrate(workload, *chooser);
+                calibrator_t::print(workload.name, costs);
+                harness_costs[idx] = costs.overhead_ns;
+            }
+        }
 
         // Register benchmarks
-        for (auto const& splitted_workloads : threads_workloads) {
+        for (size_t idx = 0; idx != threads_workloads.size(); ++idx) {
+            auto const& splitted_workloads = threads_workloads[idx];
+            auto const& readers_splitted_workloads = readers_workloads[idx];
             std::string workload_name = splitted_workloads.front().name;
-            register_benchmark(workload_name, settings.threads_count, [&](bm::State& state) {
+            double harness_ns = harness_costs[idx];
+            register_benchmark(workload_name, settings.threads_count, [&, harness_ns](bm::State& state) {
+                // Readers replay the reads of the whole workload, even if the primary only writes
                 auto const& workload = splitted_workloads[state.thread_index()];
-                bench(state, workload, *db, settings.transactional, fence);
+                workload_t primary_workload = settings.primary_writes_only ? write_part(workload) : workload;
+                bench(state,
+                      primary_workload,
+                      *db,
+                      settings.transactional,
+                      readers_splitted_workloads,
+                      readers,
+                      fence,
+                      harness_ns);
             });
         }
 
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include "src/core/types.hpp"
+#include "src/core/timer.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/worker.hpp"
+#include "src/core/workload.hpp"
+#include "src/core/operation.hpp"
+#include "src/null/null.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Own costs of the benchmark, measured against the `null` engine.
+ * Everything is in nanoseconds per call, on a single thread.
+ */
+struct harness_costs_t {
+    double chooser_ns = 0;
+    double progress_ns = 0;
+    /**
+     * @brief A pause and resume pair, which batch operations do around generating their inputs.
+     * Only the part, which isn't paused, is a harness cost and it's already in `operations_ns`.
+     */
+    double timer_ns = 0;
+    double key_ns = 0;
+    double value_ns = 0;
+    /**
+     * @brief Whole operations, including the generation of their inputs and the virtual call.
+     * Like in the main loop, the paused input generation of batch operations is excluded.
+     */
+    std::map<operation_kind_t, double> operations_ns;
+    /**
+     * @brief Mean cost of a single iteration of the workload, weighted by its proportions.
+     */
+    double overhead_ns = 0;
+};
+
+inline char const* operation_name(operation_kind_t kind) {
+    switch (kind) {
+    case operation_kind_t::upsert_k: return "upsert";
+    case operation_kind_t::update_k: return "update";
+    case operation_kind_t::remove_k: return "remove";
+    case operation_kind_t::read_k: return "read";
+    case operation_kind_t::read_modify_write_k: return "read_modify_write";
+    case operation_kind_t::batch_upsert_k: return "batch_upsert";
+    case operation_kind_t::batch_read_k: return "batch_read";
+    case operation_kind_t::bulk_load_k: return "bulk_load";
+    case operation_kind_t::range_select_k: return "range_select";
+    case operation_kind_t::scan_k: return "scan";
+    case operation_kind_t::doc_read_k: return "doc_read";
+    case operation_kind_t::doc_patch_k: return "doc_patch";
+    case operation_kind_t::edge_upsert_k: return "edge_upsert";
+    case operation_kind_t::neighbors_read_k: return "neighbors_read";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Replays a workload against the `null` engine and times every component
+ * of the benchmark loop separately: choosing the operation, generating keys and values,
+ * the operation call itself, progress accounting and timer calls.
+ * Every component runs for a fixed time budget or a number of iterations, whichever is first.
+ */
+class calibrator_t {
+  public:
+    inline calibrator_t(std::chrono::milliseconds budget = std::chrono::milliseconds(100),
+                        size_t max_iterations = 1'000'000)
+        : budget_(budget), max_iterations_(max_iterations) {}
+
+    inline harness_costs_t calibrate(workload_t const& workload, operation_chooser_t& chooser);
+
+    static inline void print(std::string const& workload_name, harness_costs_t const& costs);
+
+  private:
+    template <typename callback_at>
+    inline double measure_ns(callback_at&& callback, timer_t* timer = nullptr);
+
+    std::chrono::milliseconds budget_;
+    size_t max_iterations_;
+};
+
+/**
+ * @brief With a `timer`, only the time it wasn't paused for is accounted, just like in the main loop.
+ */
+template <typename callback_at>
+inline double calibrator_t::measure_ns(callback_at&& callback, timer_t* timer) {
+    // Clock reads are amortized over a small batch of calls
+    constexpr size_t batch_size_k = 16;
+    size_t iterations = 0;
+    auto start_time = high_resolution_clock_t::now();
+    auto start_operations_time = timer ? timer->operations_elapsed_time() : elapsed_time_t(0);
+    auto deadline = start_time + budget_;
+    auto now = start_time;
+    do {
+        for (size_t idx = 0; idx != batch_size_k; ++idx)
+            callback();
+        iterations += batch_size_k;
+        now = high_resolution_clock_t::now();
+    } while (iterations < max_iterations_ && now < deadline);
+
+    if (timer)
+        return std::chrono::duration<double, std::nano>(timer->operations_elapsed_time() - start_operations_time)
+                   .count() /
+               iterations;
+    return std::chrono::duration<double, std::nano>(now - start_time).count() / iterations;
+}
+
+inline harness_costs_t calibrator_t::calibrate(workload_t const& workload, operation_chooser_t& chooser) {
+    harness_costs_t costs;
+    null::null_t db;
+    ucsb::timer_t timer;
+    worker_t worker(workload, db, timer);
+    timer.start();
+
+    costs.chooser_ns = measure_ns([&] { bm::DoNotOptimize(chooser.choose()); });
+    costs.timer_ns = measure_ns([&] {
+        timer.pause();
+        timer.resume();
+    });
+    if (worker.key_generator_)
+        costs.key_ns = measure_ns([&] { bm::DoNotOptimize(worker.generate_key()); });
+    costs.value_ns = measure_ns([&] { bm::DoNotOptimize(worker.generate_value().data()); });
+
+    // The same shared counters, the main loop updates after every operation
+    size_t entries_touched = 0, failed_iterations = 0, bytes_processed = 0, done_iterations = 0;
+    costs.progress_ns = measure_ns([&] {
+        operation_result_t result {1, operation_status_t::ok_k};
+        bm::DoNotOptimize(result);
+        bool success = result.status == operation_status_t::ok_k;
+        atomic_add_fetch(entries_touched, size_t(success) * result.entries_touched);
+        atomic_add_fetch(failed_iterations, size_t(!success));
+        atomic_add_fetch(bytes_processed, size_t(success) * workload.value_length * result.entries_touched);
+        bm::DoNotOptimize(atomic_add_fetch(done_iterations, size_t(1)));
+    });
+
+    float proportions_sum = 0;
+    double operations_ns = 0;
+    for (auto const& [kind, proportion] : chooser.operations()) {
+        if (proportion == 0)
+            continue;
+
+        double operation_ns = 0;
+        switch (kind) {
+        case operation_kind_t::upsert_k: operation_ns = measure_ns([&] { worker.do_upsert(); }); break;
+        case operation_kind_t::update_k: operation_ns = measure_ns([&] { worker.do_update(); }); break;
+        case operation_kind_t::remove_k: operation_ns = measure_ns([&] { worker.do_remove(); }); break;
+        case operation_kind_t::read_k: operation_ns = measure_ns([&] { worker.do_read(); }); break;
+        case operation_kind_t::read_modify_write_k:
+            operation_ns = measure_ns([&] { worker.do_read_modify_write(); });
+            break;
+        case operation_kind_t::batch_upsert_k:
+            operation_ns = measure_ns([&] { worker.do_batch_upsert(); }, &timer);
+            break;
+        case operation_kind_t::batch_read_k: operation_ns = measure_ns([&] { worker.do_batch_read(); }, &timer); break;
+        case operation_kind_t::bulk_load_k: operation_ns = measure_ns([&] { worker.do_bulk_load(); }, &timer); break;
+        case operation_kind_t::range_select_k: operation_ns = measure_ns([&] { worker.do_range_select(); }); break;
+        case operation_kind_t::scan_k: operation_ns = measure_ns([&] { worker.do_scan(); }); break;
+        case operation_kind_t::doc_read_k: operation_ns = measure_ns([&] { worker.do_doc_read(); }); break;
+        case operation_kind_t::doc_patch_k: operation_ns = measure_ns([&] { worker.do_doc_patch(); }); break;
+        case operation_kind_t::edge_upsert_k: operation_ns = measure_ns([&] { worker.do_edge_upsert(); }); break;
+        case operation_kind_t::neighbors_read_k:
+            operation_ns = measure_ns([&] { worker.do_neighbors_read(); });
+            break;
+        }
+        costs.operations_ns[kind] = operation_ns;
+        operations_ns += proportion * operation_ns;
+        proportions_sum += proportion;
+    }
+    timer.stop();
+
+    if (proportions_sum > 0)
+        operations_ns /= proportions_sum;
+    costs.overhead_ns = costs.chooser_ns + costs.progress_ns + operations_ns;
+    return costs;
+}
+
+inline void calibrator_t::print(std::string const& workload_name, harness_costs_t const& costs) {
+    fmt::print(" [✱] Harness costs of {}: {:.1f}ns per operation\n", workload_name, costs.overhead_ns);
+    fmt::print("     chooser: {:.1f}ns, progress: {:.1f}ns, timer: {:.1f}ns, key: {:.1f}ns, value: {:.1f}ns\n",
+               costs.chooser_ns,
+               costs.progress_ns,
+               costs.timer_ns,
+               costs.key_ns,
+               costs.value_ns);
+    for (auto const& [kind, operation_ns] : costs.operations_ns)
+        fmt::print("     {}: {:.1f}ns\n", operation_name(kind), operation_ns);
+}
+
+} // namespace ucsb
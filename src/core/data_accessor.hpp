@@ -1,6 +1,7 @@
 #pragma once
 
 #include <set>
+#include <string_view>
 
 #include "src/core/types.hpp"
 #include "src/core/operation.hpp"
@@ -86,6 +87,48 @@ class data_accessor_t {
      * @param values A temporary buffer big enough for a all values.
      */
     virtual operation_result_t scan(key_t key, size_t length, value_span_t single_value) const = 0;
+
+    /**
+     * @brief Reads a single top-level field of a JSON document.
+     * Document and graph operations are optional, engines without
+     * such modalities keep the defaults, reporting `not_implemented_k`.
+     *
+     * @param key The document to read from.
+     * @param field The name of the field.
+     * @param value A temporary buffer for the field value.
+     */
+    virtual operation_result_t read_field(key_t /* key */,
+                                          std::string_view /* field */,
+                                          value_span_t /* value */) const {
+        return {0, operation_status_t::not_implemented_k};
+    }
+
+    /**
+     * @brief Sets a single top-level field of a JSON document,
+     * keeping the others and creating the document if it's missing.
+     *
+     * @param key The document to patch.
+     * @param field The name of the field.
+     * @param value Raw bytes, which the engine encodes into a JSON string.
+     */
+    virtual operation_result_t patch_field(key_t /* key */, std::string_view /* field */, value_spanc_t /* value */) {
+        return {0, operation_status_t::not_implemented_k};
+    }
+
+    /**
+     * @brief Inserts a directed edge between two vertices of a graph.
+     */
+    virtual operation_result_t upsert_edge(key_t /* source */, key_t /* target */) {
+        return {0, operation_status_t::not_implemented_k};
+    }
+
+    /**
+     * @brief Finds all edges of a vertex, both incoming and outgoing.
+     * The number of entries touched is the degree of the vertex.
+     */
+    virtual operation_result_t read_neighbors(key_t /* vertex */) const {
+        return {0, operation_status_t::not_implemented_k};
+    }
 };
 
 } // namespace ucsb
\ No newline at end of file
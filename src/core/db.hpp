@@ -1,6 +1,7 @@
 #pragma once
 
 #include <set>
+#include <map>
 #include <string>
 #include <memory>
 
@@ -12,6 +13,12 @@ namespace ucsb {
 
 using transaction_t = data_accessor_t;
 
+/**
+ * @brief Engine-specific metrics, reported next to the generic ones.
+ * Keys follow the `name,unit` convention of the benchmark counters.
+ */
+using db_counters_t = std::map<std::string, double>;
+
 /**
  * @brief A base class for benchmarking key-value stores.
  * This doesn't apply to transactional benchmarks.
@@ -60,6 +67,12 @@ class db_t : public data_accessor_t {
      */
     virtual size_t size_on_disk() const = 0;
 
+    /**
+     * @brief Returns the metrics accumulated since the previous call and resets them.
+     * Is called once per workload, after `flush`, so engines can report their internals.
+     */
+    virtual db_counters_t counters() { return {}; }
+
     virtual std::unique_ptr<transaction_t> create_transaction() = 0;
 };
 
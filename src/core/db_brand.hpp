@@ -2,6 +2,7 @@
 
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
+#include "src/null/null.hpp"
 
 #if defined(UCSB_HAS_USTORE)
 #include "src/ustore/ustore.hpp"
@@ -9,6 +10,9 @@
 #if defined(UCSB_HAS_ROCKSDB)
 #include "src/rocksdb/rocksdb.hpp"
 #endif
+#if defined(UCSB_HAS_SPEEDB)
+#include "src/speedb/speedb.hpp"
+#endif
 #if defined(UCSB_HAS_LEVELDB)
 #include "src/leveldb/leveldb.hpp"
 #endif
@@ -24,41 +28,79 @@
 #if defined(UCSB_HAS_LMDB)
 #include "src/lmdb/lmdb.hpp"
 #endif
+#if defined(UCSB_HAS_MDBX)
+#include "src/mdbx/mdbx.hpp"
+#endif
+#if defined(UCSB_HAS_SQLITE)
+#include "src/sqlite/sqlite.hpp"
+#endif
+#if defined(UCSB_HAS_TKRZW)
+#include "src/tkrzw/tkrzw.hpp"
+#endif
+#if defined(UCSB_HAS_SPLINTERDB)
+#include "src/splinterdb/splinterdb.hpp"
+#endif
+#if defined(UCSB_HAS_MEMORY)
+#include "src/memory/memory_hash.hpp"
+#include "src/memory/memory_btree.hpp"
+#endif
 
 namespace ucsb {
 
 enum class db_brand_t {
     unknown_k,
 
+    null_k,
     ustore_k,
     rocksdb_k,
+    speedb_k,
     leveldb_k,
     wiredtiger_k,
     mongodb_k,
     redis_k,
     lmdb_k,
+    mdbx_k,
+    sqlite_k,
+    tkrzw_k,
+    splinterdb_k,
+    memory_hash_k,
+    memory_btree_k,
 };
 
 std::shared_ptr<db_t> make_db(db_brand_t db_brand, bool transactional) {
     if (transactional) {
         switch (db_brand) {
+        case db_brand_t::null_k: return std::make_shared<null::null_t>();
 #if defined(UCSB_HAS_USTORE)
         case db_brand_t::ustore_k: return std::make_shared<ustore::ustore_t>();
 #endif
 #if defined(UCSB_HAS_ROCKSDB)
         case db_brand_t::rocksdb_k: return std::make_shared<facebook::rocksdb_t>(facebook::db_mode_t::transactional_k);
+#endif
+#if defined(UCSB_HAS_SPEEDB)
+        case db_brand_t::speedb_k: return speedb::make_db(true);
+#endif
+#if defined(UCSB_HAS_LMDB)
+        case db_brand_t::lmdb_k: return std::make_shared<symas::lmdb_t>();
+#endif
+#if defined(UCSB_HAS_MDBX)
+        case db_brand_t::mdbx_k: return std::make_shared<erthink::mdbx_t>();
 #endif
         default: break;
         }
     }
     else {
         switch (db_brand) {
+        case db_brand_t::null_k: return std::make_shared<null::null_t>();
 #if defined(UCSB_HAS_USTORE)
         case db_brand_t::ustore_k: return std::make_shared<ustore::ustore_t>();
 #endif
 #if defined(UCSB_HAS_ROCKSDB)
         case db_brand_t::rocksdb_k: return std::make_shared<facebook::rocksdb_t>(facebook::db_mode_t::regular_k);
 #endif
+#if defined(UCSB_HAS_SPEEDB)
+        case db_brand_t::speedb_k: return speedb::make_db(false);
+#endif
 #if defined(UCSB_HAS_LEVELDB)
         case db_brand_t::leveldb_k: return std::make_shared<google::leveldb_t>();
 #endif
@@ -73,6 +115,22 @@ std::shared_ptr<db_t> make_db(db_brand_t db_brand, bool transactional) {
 #endif
 #if defined(UCSB_HAS_LMDB)
         case db_brand_t::lmdb_k: return std::make_shared<symas::lmdb_t>();
+#endif
+#if defined(UCSB_HAS_MDBX)
+        case db_brand_t::mdbx_k: return std::make_shared<erthink::mdbx_t>();
+#endif
+#if defined(UCSB_HAS_SQLITE)
+        case db_brand_t::sqlite_k: return std::make_shared<sqlite::sqlite_t>();
+#endif
+#if defined(UCSB_HAS_TKRZW)
+        case db_brand_t::tkrzw_k: return std::make_shared<dbmx::tkrzw_t>();
+#endif
+#if defined(UCSB_HAS_SPLINTERDB)
+        case db_brand_t::splinterdb_k: return std::make_shared<vmware::splinterdb_t>();
+#endif
+#if defined(UCSB_HAS_MEMORY)
+        case db_brand_t::memory_hash_k: return std::make_shared<memory::memory_hash_t>();
+        case db_brand_t::memory_btree_k: return std::make_shared<memory::memory_btree_t>();
 #endif
         default: break;
         }
@@ -81,10 +139,14 @@ std::shared_ptr<db_t> make_db(db_brand_t db_brand, bool transactional) {
 }
 
 inline db_brand_t parse_db_brand(std::string const& name) {
+    if (name == "null")
+        return db_brand_t::null_k;
     if (name == "ustore")
         return db_brand_t::ustore_k;
     if (name == "rocksdb")
         return db_brand_t::rocksdb_k;
+    if (name == "speedb")
+        return db_brand_t::speedb_k;
     if (name == "leveldb")
         return db_brand_t::leveldb_k;
     if (name == "wiredtiger")
@@ -95,6 +157,18 @@ inline db_brand_t parse_db_brand(std::string const& name) {
         return db_brand_t::redis_k;
     if (name == "lmdb")
         return db_brand_t::lmdb_k;
+    if (name == "mdbx")
+        return db_brand_t::mdbx_k;
+    if (name == "sqlite")
+        return db_brand_t::sqlite_k;
+    if (name == "tkrzw")
+        return db_brand_t::tkrzw_k;
+    if (name == "splinterdb")
+        return db_brand_t::splinterdb_k;
+    if (name == "memory_hash")
+        return db_brand_t::memory_hash_k;
+    if (name == "memory_btree")
+        return db_brand_t::memory_btree_k;
     return db_brand_t::unknown_k;
 }
 
@@ -11,6 +11,12 @@ struct db_hints_t {
     size_t threads_count = 0;
     size_t records_count = 0;
     size_t value_length = 0;
+    /**
+     * @brief Set for DBs, opened by reader processes next to the primary one.
+     * Engines, which can't share files between processes, may open a replica instead.
+     */
+    bool read_replica = false;
+    size_t replica_idx = 0;
 };
 
 } // namespace ucsb
\ No newline at end of file
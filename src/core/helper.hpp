@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include <sys/stat.h>
+
 #include "src/core/types.hpp"
 
 namespace ucsb {
@@ -32,7 +34,7 @@ constexpr size_t roundup_to_multiple(size_t number) noexcept {
 
 inline bool start_with(const char* str, const char* prefix) { return strncmp(str, prefix, strlen(prefix)) == 0; }
 
-std::vector<std::string> split(std::string const& str, char delimiter) {
+inline std::vector<std::string> split(std::string const& str, char delimiter) {
     size_t start = 0;
     size_t end = 0;
     std::vector<std::string> tokens;
@@ -45,7 +47,7 @@ std::vector<std::string> split(std::string const& str, char delimiter) {
     return tokens;
 }
 
-size_t size_on_disk(fs::path const& path) {
+inline size_t size_on_disk(fs::path const& path) {
     size_t total_size = 0;
     for (auto const& entry : fs::directory_iterator(path)) {
         if (entry.is_directory())
@@ -56,7 +58,22 @@ size_t size_on_disk(fs::path const& path) {
     return total_size;
 }
 
-void clear_directory(fs::path const& dir_path) {
+/**
+ * @brief Unlike `size_on_disk`, counts only the allocated blocks, so holes of sparse files are skipped.
+ */
+inline size_t allocated_size_on_disk(fs::path const& path) {
+    size_t total_size = 0;
+    for (auto const& entry : fs::directory_iterator(path)) {
+        struct stat entry_stat;
+        if (entry.is_directory())
+            total_size += allocated_size_on_disk(entry.path());
+        else if (stat(entry.path().c_str(), &entry_stat) == 0)
+            total_size += size_t(entry_stat.st_blocks) * 512;
+    }
+    return total_size;
+}
+
+inline void clear_directory(fs::path const& dir_path) {
     for (auto const& entry : fs::directory_iterator(dir_path))
         fs::remove_all(entry.path());
 }
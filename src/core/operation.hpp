@@ -20,6 +20,10 @@ enum class operation_kind_t {
     bulk_load_k,
     range_select_k,
     scan_k,
+    doc_read_k,
+    doc_patch_k,
+    edge_upsert_k,
+    neighbors_read_k,
 };
 
 enum class operation_status_t : int {
@@ -49,6 +53,8 @@ class operation_chooser_t {
     inline void add(operation_kind_t op, float weight);
     inline operation_kind_t choose();
 
+    inline std::vector<std::pair<operation_kind_t, float>> const& operations() const { return ops_; }
+
   private:
     std::vector<std::pair<operation_kind_t, float>> ops_;
     core::random_double_generator_t generator_;
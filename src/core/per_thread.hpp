@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace ucsb {
+
+/**
+ * @brief Lazily constructed objects, one per calling thread, owned by the container.
+ * Unlike plain `thread_local`s, they are destroyed together with the container,
+ * so they can safely reference resources, like DB handles, living next to it.
+ *
+ * The lookup is lock-free after the first call on every thread. Calling `clear`
+ * concurrently with `local` is not allowed.
+ */
+template <typename object_at>
+class per_thread_t {
+  public:
+    inline per_thread_t() : epoch_(next_epoch()) {}
+    per_thread_t(per_thread_t const&) = delete;
+    per_thread_t& operator=(per_thread_t const&) = delete;
+
+    inline object_at& local();
+    template <typename callback_at>
+    inline void for_each(callback_at&& callback);
+    inline void clear();
+
+  private:
+    struct cache_t {
+        size_t epoch = 0;
+        object_at* object = nullptr;
+    };
+
+    /**
+     * @brief Epochs are unique across all the containers of the same type,
+     * so a thread never confuses objects of a destroyed container with a new one.
+     */
+    static size_t next_epoch() {
+        static std::atomic<size_t> epoch = 0;
+        return ++epoch;
+    }
+    static cache_t& cache() {
+        thread_local cache_t cache;
+        return cache;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::thread::id, object_at> objects_;
+    std::atomic<size_t> epoch_;
+};
+
+template <typename object_at>
+object_at& per_thread_t<object_at>::local() {
+    cache_t& cache = per_thread_t::cache();
+    size_t epoch = epoch_.load(std::memory_order_relaxed);
+    if (cache.epoch == epoch)
+        return *cache.object;
+
+    // References to the map elements stay valid on rehashing
+    std::lock_guard<std::mutex> lock(mutex_);
+    object_at& object = objects_[std::this_thread::get_id()];
+    cache = {epoch, &object};
+    return object;
+}
+
+template <typename object_at>
+template <typename callback_at>
+void per_thread_t<object_at>::for_each(callback_at&& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [thread_id, object] : objects_)
+        callback(object);
+}
+
+template <typename object_at>
+void per_thread_t<object_at>::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    objects_.clear();
+    epoch_ = next_epoch();
+}
+
+} // namespace ucsb
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <functional>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/timer.hpp"
+#include "src/core/worker.hpp"
+#include "src/core/workload.hpp"
+#include "src/core/operation.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Forks sibling processes, which attach to the same DB on their own
+ * and run the read part of a workload next to the threads of the main process.
+ * Only makes sense for engines, designed for multi-process access, like LMDB,
+ * others will fail to open the DB in children and report nothing.
+ *
+ * Children never return into Google Benchmark, they report back via pipes
+ * and terminate with `_exit`, so no state of the parent is ever destructed twice.
+ */
+class reader_processes_t {
+  public:
+    using db_factory_t = std::function<std::shared_ptr<db_t>(size_t process_idx)>;
+
+    struct process_result_t {
+        double operations_per_second = 0;
+        db_counters_t counters;
+    };
+
+    struct result_t {
+        size_t processes_count = 0;
+        size_t entries_touched = 0;
+        size_t bytes_processed = 0;
+        size_t done_iterations = 0;
+        size_t failed_iterations = 0;
+        /**
+         * @brief Sum of throughputs of all processes, as each one has its own timer.
+         */
+        double operations_per_second = 0;
+        std::vector<process_result_t> processes;
+    };
+
+    inline reader_processes_t(size_t count, db_factory_t factory) : count_(count), factory_(std::move(factory)) {}
+    ~reader_processes_t() { wait(); }
+
+    /**
+     * @brief Spawns the readers, if the workload has any reads at all.
+     * Every reader replays its own share of the workload, one per process.
+     */
+    inline void start(workloads_t const& workloads);
+    /**
+     * @brief Blocks until all readers are done and merges their results.
+     */
+    inline result_t wait();
+
+  private:
+    struct child_t {
+        pid_t pid = -1;
+        int pipe = -1;
+    };
+
+    struct child_result_t {
+        size_t entries_touched = 0;
+        size_t bytes_processed = 0;
+        size_t done_iterations = 0;
+        size_t failed_iterations = 0;
+        elapsed_time_t elapsed_time = elapsed_time_t(0);
+    };
+
+    [[noreturn]] inline void run_child(workload_t const& workload, size_t process_idx, int pipe);
+
+    size_t count_;
+    db_factory_t factory_;
+    std::vector<child_t> children_;
+};
+
+inline float read_proportion(workload_t const& workload) {
+    return workload.read_proportion + workload.batch_read_proportion + workload.range_select_proportion +
+           workload.scan_proportion + workload.doc_read_proportion + workload.neighbors_read_proportion;
+}
+
+/**
+ * @brief The rest of the workload, once the reads are left to the reader processes.
+ * Workloads, made of reads or writes only, are returned as is.
+ */
+inline workload_t write_part(workload_t const& workload) {
+    float proportion = read_proportion(workload);
+    if (proportion == 0 || proportion >= 1)
+        return workload;
+
+    workload_t writer_workload = workload;
+    writer_workload.operations_count = std::max(size_t(1), size_t(workload.operations_count * (1 - proportion)));
+    writer_workload.read_proportion = 0;
+    writer_workload.batch_read_proportion = 0;
+    writer_workload.range_select_proportion = 0;
+    writer_workload.scan_proportion = 0;
+    writer_workload.doc_read_proportion = 0;
+    writer_workload.neighbors_read_proportion = 0;
+    return writer_workload;
+}
+
+inline void reader_processes_t::start(workloads_t const& workloads) {
+    if (!count_ || workloads.size() < count_ || read_proportion(workloads.front()) == 0)
+        return;
+
+    for (size_t idx = 0; idx != count_; ++idx) {
+        int fds[2];
+        if (pipe(fds))
+            break;
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            ::close(fds[0]);
+            run_child(workloads[idx], idx, fds[1]);
+        }
+
+        ::close(fds[1]);
+        if (pid < 0) {
+            ::close(fds[0]);
+            break;
+        }
+        children_.push_back({pid, fds[0]});
+    }
+}
+
+inline reader_processes_t::result_t reader_processes_t::wait() {
+    result_t result;
+    for (auto const& child : children_) {
+        child_result_t child_result;
+        ssize_t read_bytes = ::read(child.pipe, &child_result, sizeof(child_result));
+
+        // Followed by DB counters, one `name value` pair per line
+        std::string counters_text;
+        char buffer[4096];
+        for (ssize_t chunk = 0; (chunk = ::read(child.pipe, buffer, sizeof(buffer))) > 0;)
+            counters_text.append(buffer, chunk);
+        ::close(child.pipe);
+
+        int status = 0;
+        waitpid(child.pid, &status, 0);
+        if (read_bytes != sizeof(child_result) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            continue;
+
+        process_result_t process_result;
+        auto seconds = std::chrono::duration<double>(child_result.elapsed_time).count();
+        if (seconds > 0)
+            process_result.operations_per_second = child_result.entries_touched / seconds;
+        std::istringstream counters_stream(counters_text);
+        std::string name;
+        double value = 0;
+        while (counters_stream >> name >> value)
+            process_result.counters[name] = value;
+
+        ++result.processes_count;
+        result.entries_touched += child_result.entries_touched;
+        result.bytes_processed += child_result.bytes_processed;
+        result.done_iterations += child_result.done_iterations;
+        result.failed_iterations += child_result.failed_iterations;
+        result.operations_per_second += process_result.operations_per_second;
+        result.processes.push_back(std::move(process_result));
+    }
+    children_.clear();
+    return result;
+}
+
+inline void reader_processes_t::run_child(workload_t const& workload, size_t process_idx, int pipe) {
+    child_result_t result;
+    std::string counters_text;
+    int exit_code = 1;
+    try {
+        std::shared_ptr<db_t> db = factory_(process_idx);
+        std::string error;
+        if (db && db->open(error)) {
+            // Only the reads are replayed, keeping their relative proportions
+            workload_t reader_workload = workload;
+            float proportion = read_proportion(workload);
+            reader_workload.operations_count = std::max(size_t(1), size_t(workload.operations_count * proportion));
+
+            operation_chooser_t chooser;
+            chooser.add(operation_kind_t::read_k, workload.read_proportion);
+            chooser.add(operation_kind_t::batch_read_k, workload.batch_read_proportion);
+            chooser.add(operation_kind_t::range_select_k, workload.range_select_proportion);
+            chooser.add(operation_kind_t::scan_k, workload.scan_proportion);
+            chooser.add(operation_kind_t::doc_read_k, workload.doc_read_proportion);
+            chooser.add(operation_kind_t::neighbors_read_k, workload.neighbors_read_proportion);
+
+            ucsb::timer_t timer;
+            worker_t worker(reader_workload, *db, timer);
+            timer.start();
+            for (size_t idx = 0; idx != reader_workload.operations_count; ++idx) {
+                operation_result_t op_result;
+                switch (chooser.choose()) {
+                case operation_kind_t::read_k: op_result = worker.do_read(); break;
+                case operation_kind_t::batch_read_k: op_result = worker.do_batch_read(); break;
+                case operation_kind_t::range_select_k: op_result = worker.do_range_select(); break;
+                case operation_kind_t::scan_k: op_result = worker.do_scan(); break;
+                case operation_kind_t::doc_read_k: op_result = worker.do_doc_read(); break;
+                case operation_kind_t::neighbors_read_k: op_result = worker.do_neighbors_read(); break;
+                default: break;
+                }
+
+                bool success = op_result.status == operation_status_t::ok_k;
+                result.entries_touched += size_t(success) * op_result.entries_touched;
+                result.bytes_processed += size_t(success) * workload.value_length * op_result.entries_touched;
+                result.failed_iterations += size_t(!success);
+                ++result.done_iterations;
+            }
+            timer.stop();
+            result.elapsed_time = timer.operations_elapsed_time();
+            // Counter names never contain whitespaces
+            for (auto const& [name, value] : db->counters())
+                counters_text += name + " " + std::to_string(value) + "\n";
+            db->close();
+            exit_code = 0;
+        }
+    }
+    catch (...) {
+    }
+
+    if (::write(pipe, &result, sizeof(result)) != sizeof(result))
+        exit_code = 1;
+    else if (::write(pipe, counters_text.data(), counters_text.size()) != ssize_t(counters_text.size()))
+        exit_code = 1;
+    ::close(pipe);
+    _exit(exit_code);
+}
+
+} // namespace ucsb
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include "src/core/db.hpp"
+
+namespace ucsb {
+
+/**
+ * @brief Parses a CPU list in the format of `taskset -c`, like "0-3,8".
+ */
+inline bool parse_cpu_set(std::string const& cpus, cpu_set_t& cpu_set) {
+    CPU_ZERO(&cpu_set);
+    size_t pos = 0;
+    while (pos < cpus.size()) {
+        size_t end = cpus.find(',', pos);
+        if (end == std::string::npos)
+            end = cpus.size();
+        std::string range = cpus.substr(pos, end - pos);
+        pos = end + 1;
+
+        char* range_end = nullptr;
+        long first = std::strtol(range.c_str(), &range_end, 10);
+        long last = *range_end == '-' ? std::strtol(range_end + 1, &range_end, 10) : first;
+        if (*range_end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE)
+            return false;
+        for (long cpu = first; cpu <= last; ++cpu)
+            CPU_SET(cpu, &cpu_set);
+    }
+    return CPU_COUNT(&cpu_set) != 0;
+}
+
+/**
+ * @brief Manages the server process of a client-server DB.
+ * The server is started in foreground as a child process, optionally pinned
+ * to a set of CPUs, which should be disjoint from the ones the benchmark runs on.
+ * Instead of sleeping, readiness is probed by the DB client and the server is
+ * stopped with `SIGTERM`, escalating to `SIGKILL` only on timeout.
+ *
+ * While the server is running, a sibling thread samples its CPU time and RSS
+ * from "/proc/<pid>/stat", as `cpu_profiler_t` and `mem_profiler_t`
+ * only see the benchmark process itself.
+ */
+class server_process_t {
+  public:
+    struct stats_t {
+        float cpu_max = 0;
+        float cpu_avg = 0;
+        size_t rss_max = 0;
+        size_t rss_avg = 0;
+    };
+
+    inline server_process_t(size_t request_delay = 100)
+        : time_to_die_(true), request_delay_(request_delay), page_size_(sysconf(_SC_PAGE_SIZE)),
+          ticks_per_second_(sysconf(_SC_CLK_TCK)) {}
+    ~server_process_t() { stop(); }
+
+    server_process_t(server_process_t const&) = delete;
+    server_process_t& operator=(server_process_t const&) = delete;
+
+    /**
+     * @brief Spawns `args[0]` from `PATH`, with output redirected to "/dev/null".
+     * @param cpus CPU list to pin the server to, all CPUs if empty.
+     */
+    inline bool start(std::vector<std::string> const& args, std::string const& cpus, std::string& error);
+    /**
+     * @brief Calls `probe` until it returns true without throwing.
+     * Fails early, if the server dies in the meantime.
+     */
+    template <typename probe_at>
+    inline bool wait_ready(probe_at&& probe, std::chrono::milliseconds timeout, std::string& error);
+    inline void stop(std::chrono::milliseconds timeout = std::chrono::seconds(60));
+
+    inline bool is_running() const { return pid_ > 0; }
+
+    /**
+     * @brief Stats since the server got ready or since the last call.
+     */
+    inline stats_t stats();
+
+  private:
+    struct sample_t {
+        size_t cpu_ticks = 0;
+        size_t rss = 0;
+    };
+
+    inline bool exited(int& status);
+    inline bool sample(sample_t& sample) const;
+    inline void request_usage();
+
+    pid_t pid_ = -1;
+    std::string name_;
+
+    std::thread thread_;
+    std::atomic_bool time_to_die_;
+    std::mutex stats_mutex_;
+    stats_t stats_;
+    size_t requests_count_ = 0;
+
+    size_t request_delay_;
+    size_t page_size_;
+    size_t ticks_per_second_;
+};
+
+inline bool server_process_t::start(std::vector<std::string> const& args,
+                                    std::string const& cpus,
+                                    std::string& error) {
+    if (args.empty()) {
+        error = "Empty server command";
+        return false;
+    }
+
+    cpu_set_t cpu_set;
+    if (!cpus.empty() && !parse_cpu_set(cpus, cpu_set)) {
+        error = "Invalid server CPU list: " + cpus;
+        return false;
+    }
+
+    std::vector<char*> argv;
+    for (auto const& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        error = "Failed to fork " + args.front();
+        return false;
+    }
+    if (pid == 0) {
+        // Only async-signal-safe calls past this point
+        if (!cpus.empty() && sched_setaffinity(0, sizeof(cpu_set), &cpu_set))
+            _exit(126);
+        int null_fd = ::open("/dev/null", O_RDWR);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDIN_FILENO);
+            dup2(null_fd, STDOUT_FILENO);
+            ::close(null_fd);
+        }
+        execvp(argv.front(), argv.data());
+        _exit(127);
+    }
+
+    pid_ = pid;
+    name_ = args.front();
+    return true;
+}
+
+template <typename probe_at>
+inline bool server_process_t::wait_ready(probe_at&& probe, std::chrono::milliseconds timeout, std::string& error) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        int status = 0;
+        if (exited(status)) {
+            error = name_ + " exited with code " + std::to_string(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+            return false;
+        }
+
+        try {
+            if (probe())
+                break;
+        }
+        catch (...) {
+        }
+
+        if (std::chrono::steady_clock::now() > deadline) {
+            error = name_ + " isn't ready after " + std::to_string(timeout.count()) + "ms";
+            stop();
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    stats_ = {};
+    requests_count_ = 0;
+    time_to_die_.store(false);
+    thread_ = std::thread(&server_process_t::request_usage, this);
+    return true;
+}
+
+inline void server_process_t::stop(std::chrono::milliseconds timeout) {
+    if (!time_to_die_.load()) {
+        time_to_die_.store(true);
+        thread_.join();
+    }
+    if (pid_ <= 0)
+        return;
+
+    int status = 0;
+    kill(pid_, SIGTERM);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!exited(status)) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            kill(pid_, SIGKILL);
+            waitpid(pid_, &status, 0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    pid_ = -1;
+}
+
+inline server_process_t::stats_t server_process_t::stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_t stats = stats_;
+    stats_ = {};
+    requests_count_ = 0;
+    return stats;
+}
+
+inline bool server_process_t::exited(int& status) {
+    if (pid_ <= 0)
+        return true;
+    if (waitpid(pid_, &status, WNOHANG) != pid_)
+        return false;
+    pid_ = -1;
+    return true;
+}
+
+inline bool server_process_t::sample(sample_t& sample) const {
+    std::ifstream stat("/proc/" + std::to_string(pid_) + "/stat", std::ios_base::in);
+    std::string line;
+    if (!std::getline(stat, line))
+        return false;
+
+    // The command name may contain spaces, so fields are counted from its closing bracket
+    size_t pos = line.rfind(')');
+    if (pos == std::string::npos)
+        return false;
+    std::istringstream fields(line.substr(pos + 1));
+    std::string skipped;
+    size_t utime = 0, stime = 0, rss = 0;
+    for (size_t idx = 3; idx != 14; ++idx)
+        fields >> skipped;
+    fields >> utime >> stime;
+    for (size_t idx = 16; idx != 24; ++idx)
+        fields >> skipped;
+    fields >> rss;
+    if (!fields)
+        return false;
+
+    sample.cpu_ticks = utime + stime;
+    sample.rss = rss * page_size_;
+    return true;
+}
+
+inline void server_process_t::request_usage() {
+    sample_t last_sample;
+    bool first_time = !sample(last_sample);
+    auto last_time = std::chrono::steady_clock::now();
+
+    while (!time_to_die_.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(request_delay_));
+
+        sample_t current_sample;
+        if (!sample(current_sample))
+            continue;
+        auto current_time = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(current_time - last_time).count();
+
+        if (!first_time && seconds > 0) {
+            float percent = 100.0 * (current_sample.cpu_ticks - last_sample.cpu_ticks) / ticks_per_second_ / seconds;
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++requests_count_;
+            stats_.cpu_max = std::max(percent, stats_.cpu_max);
+            stats_.cpu_avg = (stats_.cpu_avg * (requests_count_ - 1) + percent) / requests_count_;
+            stats_.rss_max = std::max(current_sample.rss, stats_.rss_max);
+            stats_.rss_avg = (stats_.rss_avg * (requests_count_ - 1) + current_sample.rss) / requests_count_;
+        }
+        first_time = false;
+        last_sample = current_sample;
+        last_time = current_time;
+    }
+}
+
+/**
+ * @brief Reports stats of servers next to the ones of the benchmark process.
+ * With multiple servers, like shards, those are summed up.
+ */
+inline void add_server_counters(std::vector<server_process_t::stats_t> const& servers_stats, db_counters_t& counters) {
+    if (servers_stats.empty())
+        return;
+
+    server_process_t::stats_t total;
+    for (auto const& stats : servers_stats) {
+        total.cpu_max += stats.cpu_max;
+        total.cpu_avg += stats.cpu_avg;
+        total.rss_max += stats.rss_max;
+        total.rss_avg += stats.rss_avg;
+    }
+    counters["server_cpu_max,%"] = total.cpu_max;
+    counters["server_cpu_avg,%"] = total.cpu_avg;
+    counters["server_mem_max(rss),bytes"] = double(total.rss_max);
+    counters["server_mem_avg(rss),bytes"] = double(total.rss_avg);
+}
+
+} // namespace ucsb
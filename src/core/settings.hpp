@@ -16,10 +16,13 @@ struct settings_t {
     fs::path workloads_file_path;
     std::string workload_filter;
     size_t threads_count = 0;
+    size_t reader_processes_count = 0;
+    bool primary_writes_only = false;
 
     fs::path results_file_path;
     size_t run_idx = 0;
     size_t runs_count = 0;
+    bool calibrate = false;
 };
 
 } // namespace ucsb
\ No newline at end of file
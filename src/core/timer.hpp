@@ -14,6 +14,8 @@ using elapsed_time_t = std::chrono::nanoseconds;
 /**
  * @brief Trivial Google Benchmark wrapper.
  * No added value here :)
+ * Default constructed timer isn't bound to a benchmark and only
+ * tracks the real time, which is used outside of Google Benchmark.
  */
 class timer_t {
   public:
@@ -23,22 +25,26 @@ class timer_t {
         paused_k,
     };
 
+    inline timer_t() : bench_(nullptr), state_(state_t::stopped_k) {}
     inline timer_t(bm::State& bench) : bench_(&bench), state_(state_t::stopped_k) {}
 
     // Google benchmark timer methods
+    // Note: Own costs of Google Benchmark stay outside of the operations time, so they match the calibration
     inline void pause() {
-        bench_->PauseTiming();
-
         assert(state_ == state_t::running_k);
         recalculate_operations_elapsed_time();
         state_ = state_t::paused_k;
+
+        if (bench_)
+            bench_->PauseTiming();
     }
     inline void resume() {
+        if (bench_)
+            bench_->ResumeTiming();
+
         assert(state_ == state_t::paused_k);
         operations_start_time_ = high_resolution_clock_t::now();
         state_ = state_t::running_k;
-
-        bench_->ResumeTiming();
     }
 
     // Helper methods to calculate real time statistics
@@ -4,6 +4,7 @@
 #include <memory>
 #include <utility>
 #include <set>
+#include <string>
 #include <fmt/format.h>
 
 #include "src/core/types.hpp"
@@ -48,8 +49,14 @@ class worker_t {
     inline operation_result_t do_bulk_load();
     inline operation_result_t do_range_select();
     inline operation_result_t do_scan();
+    inline operation_result_t do_doc_read();
+    inline operation_result_t do_doc_patch();
+    inline operation_result_t do_edge_upsert();
+    inline operation_result_t do_neighbors_read();
 
   private:
+    friend class calibrator_t;
+
     inline key_generator_t create_key_generator(workload_t const& workload,
                                                 core::counter_generator_t& counter_generator);
     inline value_length_generator_t create_value_length_generator(workload_t const& workload);
@@ -62,6 +69,7 @@ class worker_t {
     inline keys_spanc_t generate_batch_upsert_keys();
     inline keys_spanc_t generate_batch_read_keys();
     inline keys_spanc_t generate_bulk_load_keys();
+    inline std::string_view generate_doc_field();
     inline value_spanc_t generate_value();
     inline values_and_sizes_spanc_t generate_values(size_t count);
     inline value_span_t value_buffer();
@@ -85,6 +93,9 @@ class worker_t {
     length_generator_t batch_read_length_generator_;
     length_generator_t bulk_load_length_generator_;
     length_generator_t range_select_length_generator_;
+
+    std::vector<std::string> doc_fields_;
+    length_generator_t doc_field_generator_;
 };
 
 worker_t::worker_t(workload_t const& workload, data_accessor_t& data_accessor, timer_t& timer)
@@ -115,6 +126,10 @@ worker_t::worker_t(workload_t const& workload, data_accessor_t& data_accessor, t
     batch_read_length_generator_ = create_batch_read_length_generator(workload);
     bulk_load_length_generator_ = create_bulk_load_length_generator(workload);
     range_select_length_generator_ = create_range_select_length_generator(workload);
+
+    for (size_t idx = 0; idx != std::max(workload.doc_fields_count, size_t(1)); ++idx)
+        doc_fields_.push_back(fmt::format("field{}", idx));
+    doc_field_generator_ = std::make_unique<core::uniform_generator_gt<size_t>>(0, doc_fields_.size() - 1);
 }
 
 inline operation_result_t worker_t::do_upsert() {
@@ -193,6 +208,31 @@ inline operation_result_t worker_t::do_scan() {
     return data_accessor_->scan(workload_.start_key, workload_.records_count, single_value);
 }
 
+inline operation_result_t worker_t::do_doc_read() {
+    key_t key = generate_key();
+    std::string_view field = generate_doc_field();
+    value_span_t value = value_buffer();
+    return data_accessor_->read_field(key, field, value);
+}
+
+inline operation_result_t worker_t::do_doc_patch() {
+    key_t key = generate_key();
+    std::string_view field = generate_doc_field();
+    value_spanc_t value = generate_value();
+    return data_accessor_->patch_field(key, field, value);
+}
+
+inline operation_result_t worker_t::do_edge_upsert() {
+    key_t source = generate_key();
+    key_t target = generate_key();
+    return data_accessor_->upsert_edge(source, target);
+}
+
+inline operation_result_t worker_t::do_neighbors_read() {
+    key_t vertex = generate_key();
+    return data_accessor_->read_neighbors(vertex);
+}
+
 inline worker_t::key_generator_t worker_t::create_key_generator(workload_t const& workload,
                                                                 core::counter_generator_t& counter_generator) {
     key_generator_t generator;
@@ -357,6 +397,8 @@ inline keys_spanc_t worker_t::generate_bulk_load_keys() {
     return keys;
 }
 
+inline std::string_view worker_t::generate_doc_field() { return doc_fields_[doc_field_generator_->generate()]; }
+
 inline value_spanc_t worker_t::generate_value() {
     values_and_sizes_spanc_t value_and_size = generate_values(1);
     return value_spanc_t {value_and_size.first.data(), value_and_size.second.front()};
@@ -55,6 +55,10 @@ struct workload_t {
     float bulk_load_proportion = 0;
     float range_select_proportion = 0;
     float scan_proportion = 0;
+    float doc_read_proportion = 0;
+    float doc_patch_proportion = 0;
+    float edge_upsert_proportion = 0;
+    float neighbors_read_proportion = 0;
 
     key_t start_key = 0;
     distribution_kind_t key_dist = distribution_kind_t::uniform_k;
@@ -77,6 +81,12 @@ struct workload_t {
     size_t range_select_min_length = 0;
     size_t range_select_max_length = 0;
     distribution_kind_t range_select_length_dist = distribution_kind_t::uniform_k;
+
+    /**
+     * @brief Number of top-level fields in every JSON document.
+     * Document operations pick one of them uniformly.
+     */
+    size_t doc_fields_count = 8;
 };
 
 using workloads_t = std::vector<workload_t>;
@@ -128,6 +138,10 @@ bool load(fs::path const& path, workloads_t& workloads) {
         workload.bulk_load_proportion = (*j_workload).value("bulk_load_proportion", 0.0);
         workload.range_select_proportion = (*j_workload).value("range_select_proportion", 0.0);
         workload.scan_proportion = (*j_workload).value("scan_proportion", 0.0);
+        workload.doc_read_proportion = (*j_workload).value("doc_read_proportion", 0.0);
+        workload.doc_patch_proportion = (*j_workload).value("doc_patch_proportion", 0.0);
+        workload.edge_upsert_proportion = (*j_workload).value("edge_upsert_proportion", 0.0);
+        workload.neighbors_read_proportion = (*j_workload).value("neighbors_read_proportion", 0.0);
 
         workload.start_key = (*j_workload).value("start_key", 0);
         workload.key_dist = parse_distribution((*j_workload).value("key_dist", "uniform"));
@@ -177,6 +191,8 @@ bool load(fs::path const& path, workloads_t& workloads) {
             return false;
         }
 
+        workload.doc_fields_count = (*j_workload).value("doc_fields_count", 8);
+
         workloads.push_back(workload);
     }
 
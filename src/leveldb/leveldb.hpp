@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 #include <fmt/format.h>
 #include <nlohmann/json.hpp>
@@ -18,6 +21,7 @@
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/per_thread.hpp"
 
 namespace ucsb::google {
 
@@ -41,6 +45,13 @@ inline leveldb::Slice to_slice(value_spanc_t value) {
     return {reinterpret_cast<char const*>(value.data()), value.size()};
 }
 
+/*
+ * @brief Preallocated buffers used for batch operations.
+ * Globals and especially `thread_local`s are a bad practice.
+ */
+thread_local std::vector<key_t> batch_keys;
+thread_local std::string value_buffer;
+
 /**
  * @brief LevelDB wrapper for the UCSB benchmark.
  * It's the precursor of RocksDB by Facebook.
@@ -48,7 +59,7 @@ inline leveldb::Slice to_slice(value_spanc_t value) {
  */
 class leveldb_t : public ucsb::db_t {
   public:
-    inline leveldb_t() : db_(nullptr) {}
+    inline leveldb_t() : db_(nullptr), full_compaction_(false) {}
     ~leveldb_t() { close(); }
 
     void set_config(fs::path const& config_path,
@@ -87,8 +98,25 @@ class leveldb_t : public ucsb::db_t {
         std::string compression;
         size_t cache_size = 0;
         size_t filter_bits = -1;
+        bool sorted_batch_read = true;
+        bool pooled_iterators = true;
     };
 
+    /**
+     * @brief LevelDB iterators can't be refreshed, they stick to the version they
+     * were created at. So pooled ones are reused only until the next write.
+     */
+    struct pooled_iterator_t {
+        std::unique_ptr<leveldb::Iterator> iterator;
+        size_t writes_epoch = 0;
+    };
+
+    leveldb::Iterator* pooled_iterator() const;
+    inline void on_write() {
+        if (config_.pooled_iterators)
+            writes_epoch_.fetch_add(1, std::memory_order_relaxed);
+    }
+
     inline bool load_config(config_t& config);
 
     class key_comparator_t final : public leveldb::Comparator {
@@ -109,13 +137,18 @@ class leveldb_t : public ucsb::db_t {
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
+    config_t config_;
 
     leveldb::Options options_;
     leveldb::ReadOptions read_options_;
     leveldb::WriteOptions write_options_;
 
+    mutable per_thread_t<pooled_iterator_t> pooled_iterators_;
+    std::atomic<size_t> writes_epoch_ = 0;
+
     std::unique_ptr<leveldb::DB> db_;
     key_comparator_t key_cmp_;
+    std::atomic_bool full_compaction_;
 };
 
 void leveldb_t::set_config(fs::path const& config_path,
@@ -136,8 +169,7 @@ bool leveldb_t::open(std::string& error) {
         return false;
     }
 
-    config_t config;
-    if (!load_config(config)) {
+    if (!load_config(config_)) {
         error = "Failed to load config";
         return false;
     }
@@ -145,32 +177,39 @@ bool leveldb_t::open(std::string& error) {
     options_ = leveldb::Options();
     options_.create_if_missing = true;
     // options_.comparator = &key_cmp_;
-    if (config.write_buffer_size > 0)
-        options_.write_buffer_size = config.write_buffer_size;
-    if (config.max_file_size > 0)
-        options_.max_file_size = config.max_file_size;
-    if (config.max_open_files > 0)
-        options_.max_open_files = config.max_open_files;
-    if (config.compression == "snappy")
+    if (config_.write_buffer_size > 0)
+        options_.write_buffer_size = config_.write_buffer_size;
+    if (config_.max_file_size > 0)
+        options_.max_file_size = config_.max_file_size;
+    if (config_.max_open_files > 0)
+        options_.max_open_files = config_.max_open_files;
+    if (config_.compression == "snappy")
         options_.compression = leveldb::kSnappyCompression;
     else
         options_.compression = leveldb::kNoCompression;
-    if (config.cache_size > 0)
-        options_.block_cache = leveldb::NewLRUCache(config.cache_size);
-    if (config.filter_bits > 0)
-        options_.filter_policy = leveldb::NewBloomFilterPolicy(config.filter_bits);
+    if (config_.cache_size > 0)
+        options_.block_cache = leveldb::NewLRUCache(config_.cache_size);
+    if (config_.filter_bits > 0)
+        options_.filter_policy = leveldb::NewBloomFilterPolicy(config_.filter_bits);
 
     leveldb::DB* db_raw = nullptr;
     leveldb::Status status = leveldb::DB::Open(options_, main_dir_path_.string(), &db_raw);
     db_.reset(db_raw);
+    full_compaction_.store(false);
 
     error = status.ok() ? std::string() : status.ToString();
     return status.ok();
 }
 
-void leveldb_t::close() { db_.reset(nullptr); }
+void leveldb_t::close() {
+    batch_keys.clear();
+    value_buffer.clear();
+    pooled_iterators_.clear();
+    db_.reset(nullptr);
+}
 
 operation_result_t leveldb_t::upsert(key_t key, value_spanc_t value) {
+    on_write();
     leveldb::Status status = db_->Put(write_options_, to_slice(key), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -184,11 +223,13 @@ operation_result_t leveldb_t::update(key_t key, value_spanc_t value) {
     else if (!status.ok())
         return {0, operation_status_t::error_k};
 
+    on_write();
     status = db_->Put(write_options_, to_slice(key), to_slice(value));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t leveldb_t::remove(key_t key) {
+    on_write();
     leveldb::Status status = db_->Delete(write_options_, to_slice(key));
     return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -196,15 +237,14 @@ operation_result_t leveldb_t::remove(key_t key) {
 operation_result_t leveldb_t::read(key_t key, value_span_t value) const {
 
     // Unlike RocksDB, we can't read into some form fo a `PinnableSlice`,
-    // just `std::string`, causing heap allocations.
-    std::string data;
-    leveldb::Status status = db_->Get(read_options_, to_slice(key), &data);
+    // just `std::string`, so at least reuse its capacity between calls.
+    leveldb::Status status = db_->Get(read_options_, to_slice(key), &value_buffer);
     if (status.IsNotFound())
         return {0, operation_status_t::not_found_k};
     else if (!status.ok())
         return {0, operation_status_t::error_k};
 
-    memcpy(value.data(), data.data(), data.size());
+    memcpy(value.data(), value_buffer.data(), value_buffer.size());
     return {1, operation_status_t::ok_k};
 }
 
@@ -218,6 +258,7 @@ operation_result_t leveldb_t::batch_upsert(keys_spanc_t keys, values_spanc_t val
         offset += sizes[idx];
     }
 
+    on_write();
     leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
     return {keys.size(), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
 }
@@ -225,17 +266,43 @@ operation_result_t leveldb_t::batch_upsert(keys_spanc_t keys, values_spanc_t val
 operation_result_t leveldb_t::batch_read(keys_spanc_t keys, values_span_t values) const {
 
     // Note: imitation of batch read!
+    // All lookups are served from the same snapshot, to match the semantics of a real batch.
+    leveldb::ReadOptions batch_options = read_options_;
+    batch_options.snapshot = db_->GetSnapshot();
+
     size_t offset = 0;
     size_t found_cnt = 0;
-    for (auto key : keys) {
-        std::string data;
-        leveldb::Status status = db_->Get(read_options_, to_slice(key), &data);
-        if (status.ok()) {
-            memcpy(values.data() + offset, data.data(), data.size());
-            offset += data.size();
+    if (config_.sorted_batch_read) {
+        // Sorting keys in the order of the bytewise comparator turns random lookups into
+        // forward seeks of a single iterator, which reuses the already loaded blocks.
+        batch_keys.assign(keys.begin(), keys.end());
+        std::sort(batch_keys.begin(), batch_keys.end(), [](key_t left, key_t right) {
+            return __builtin_bswap64(left) < __builtin_bswap64(right);
+        });
+
+        std::unique_ptr<leveldb::Iterator> it(db_->NewIterator(batch_options));
+        for (auto key : batch_keys) {
+            auto key_slice = to_slice(key);
+            it->Seek(key_slice);
+            if (!it->Valid() || it->key() != key_slice)
+                continue;
+            memcpy(values.data() + offset, it->value().data(), it->value().size());
+            offset += it->value().size();
             ++found_cnt;
         }
     }
+    else {
+        for (auto key : keys) {
+            leveldb::Status status = db_->Get(batch_options, to_slice(key), &value_buffer);
+            if (status.ok()) {
+                memcpy(values.data() + offset, value_buffer.data(), value_buffer.size());
+                offset += value_buffer.size();
+                ++found_cnt;
+            }
+        }
+    }
+
+    db_->ReleaseSnapshot(batch_options.snapshot);
     return {found_cnt, operation_status_t::ok_k};
 }
 
@@ -246,14 +313,25 @@ operation_result_t leveldb_t::bulk_load(keys_spanc_t keys, values_spanc_t values
     // The most efficient alternative is to use `WriteBatch`, which comes with a very
     // scarce set of options.
     // https://github.com/google/leveldb/blob/main/include/leveldb/options.h
-    return batch_upsert(keys, values, sizes);
+    auto result = batch_upsert(keys, values, sizes);
+    if (result.status == operation_status_t::ok_k)
+        full_compaction_.store(true);
+    return result;
 }
 
 operation_result_t leveldb_t::range_select(key_t key, size_t length, values_span_t values) const {
 
+    std::unique_ptr<leveldb::Iterator> owned_it;
+    leveldb::Iterator* it = nullptr;
+    if (config_.pooled_iterators)
+        it = pooled_iterator();
+    else {
+        owned_it.reset(db_->NewIterator(read_options_));
+        it = owned_it.get();
+    }
+
     size_t i = 0;
     size_t exported_bytes = 0;
-    std::unique_ptr<leveldb::Iterator> it(db_->NewIterator(read_options_));
     it->Seek(to_slice(key));
     for (; it->Valid() && i != length; i++, it->Next()) {
         memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
@@ -274,10 +352,27 @@ operation_result_t leveldb_t::scan(key_t key, size_t length, value_span_t single
     return {i, operation_status_t::ok_k};
 }
 
+leveldb::Iterator* leveldb_t::pooled_iterator() const {
+    pooled_iterator_t& pooled = pooled_iterators_.local();
+    size_t writes_epoch = writes_epoch_.load(std::memory_order_relaxed);
+    if (!pooled.iterator || pooled.writes_epoch != writes_epoch) {
+        pooled.iterator.reset(db_->NewIterator(read_options_));
+        pooled.writes_epoch = writes_epoch;
+    }
+    return pooled.iterator.get();
+}
+
 std::string leveldb_t::info() { return fmt::format("v{}.{}", leveldb::kMajorVersion, leveldb::kMinorVersion); }
 
 void leveldb_t::flush() {
-    // Nothing to do
+    // LevelDB has no public way to flush just the memtable, but compacting the whole
+    // key range does that too and pushes all the freshly loaded data out of L0.
+    // It's only done after bulk loads, similar to RocksDB.
+    if (full_compaction_.exchange(false)) {
+        db_->CompactRange(nullptr, nullptr);
+        // Let pooled iterators release the compacted files
+        on_write();
+    }
 }
 
 size_t leveldb_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
@@ -298,6 +393,8 @@ bool leveldb_t::load_config(config_t& config) {
     config.compression = j_config.value<std::string>("compression", "none");
     config.cache_size = j_config.value<size_t>("cache_size", size_t(134'217'728));
     config.filter_bits = j_config.value<size_t>("filter_bits", size_t(10));
+    config.sorted_batch_read = j_config.value<bool>("sorted_batch_read", true);
+    config.pooled_iterators = j_config.value<bool>("pooled_iterators", true);
 
     return true;
 }
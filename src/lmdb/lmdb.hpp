@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <sys/stat.h>
 
 #include <fmt/format.h>
@@ -13,6 +14,8 @@
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
 
+#include "lmdb_transaction.hpp"
+
 namespace ucsb::symas {
 
 namespace fs = ucsb::fs;
@@ -73,6 +76,16 @@ class lmdb_t : public ucsb::db_t {
         bool no_meta_sync = false;
         bool no_read_a_head = false;
         bool write_map = false;
+        bool integer_keys = true;
+
+        /**
+         * @brief Records committed per write transaction during `bulk_load`.
+         * Zero means the whole bulk goes into a single transaction.
+         */
+        size_t bulk_load_txn_records = 0;
+        bool bulk_load_append = true;
+        bool sync_on_flush = false;
+        size_t transaction_commit_ops = 0;
     };
 
     bool load_config(config_t& config);
@@ -80,24 +93,21 @@ class lmdb_t : public ucsb::db_t {
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
+    db_hints_t hints_;
+    config_t config_;
 
     MDB_env* env_;
     MDB_dbi dbi_;
 };
 
-inline static int compare_keys(MDB_val const* left, MDB_val const* right) noexcept {
-    key_t left_key = *reinterpret_cast<key_t const*>(left->mv_data);
-    key_t right_key = *reinterpret_cast<key_t const*>(right->mv_data);
-    return left_key < right_key ? -1 : left_key > right_key;
-}
-
 void lmdb_t::set_config(fs::path const& config_path,
                         fs::path const& main_dir_path,
                         std::vector<fs::path> const& storage_dir_paths,
-                        [[maybe_unused]] db_hints_t const& hints) {
+                        db_hints_t const& hints) {
     config_path_ = config_path;
     main_dir_path_ = main_dir_path;
     storage_dir_paths_ = storage_dir_paths;
+    hints_ = hints;
 }
 
 bool lmdb_t::open(std::string& error) {
@@ -109,20 +119,19 @@ bool lmdb_t::open(std::string& error) {
         return false;
     }
 
-    config_t config;
-    if (!load_config(config)) {
+    if (!load_config(config_)) {
         error = "Failed to load config";
         return false;
     }
 
     int env_opt = 0;
-    if (config.no_sync)
+    if (config_.no_sync)
         env_opt |= MDB_NOSYNC;
-    if (config.no_meta_sync)
+    if (config_.no_meta_sync)
         env_opt |= MDB_NOMETASYNC;
-    if (config.no_read_a_head)
+    if (config_.no_read_a_head)
         env_opt |= MDB_NORDAHEAD;
-    if (config.write_map)
+    if (config_.write_map)
         env_opt |= MDB_WRITEMAP;
 
     int res = mdb_env_create(&env_);
@@ -130,8 +139,8 @@ bool lmdb_t::open(std::string& error) {
         error = "Failed to create environment";
         return false;
     }
-    if (config.map_size > 0) {
-        res = mdb_env_set_mapsize(env_, config.map_size);
+    if (config_.map_size > 0) {
+        res = mdb_env_set_mapsize(env_, config_.map_size);
         if (res) {
             close();
             error = "Failed to apply config";
@@ -153,7 +162,9 @@ bool lmdb_t::open(std::string& error) {
         error = "Failed to begin transaction";
         return false;
     }
-    res = mdb_open(txn, nullptr, 0, &dbi_);
+    // Native `size_t` keys are little-endian, so the default `memcmp` order doesn't match
+    // the numeric one. `MDB_INTEGERKEY` fixes that and makes sorted inputs appendable.
+    res = mdb_open(txn, nullptr, config_.integer_keys ? MDB_INTEGERKEY : 0, &dbi_);
     if (res) {
         close();
         error = "Failed to open DB";
@@ -194,7 +205,6 @@ operation_result_t lmdb_t::upsert(key_t key, value_spanc_t value) {
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_put(txn, dbi_, &key_slice, &val_slice, 0);
     if (res) {
         mdb_txn_abort(txn);
@@ -215,7 +225,6 @@ operation_result_t lmdb_t::update(key_t key, value_spanc_t value) {
     int res = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_get(txn, dbi_, &key_slice, &val_slice);
     if (res) {
         mdb_txn_abort(txn);
@@ -246,7 +255,6 @@ operation_result_t lmdb_t::remove(key_t key) {
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_del(txn, dbi_, &key_slice, nullptr);
     if (res) {
         mdb_txn_abort(txn);
@@ -267,7 +275,6 @@ operation_result_t lmdb_t::read(key_t key, value_span_t value) const {
     int res = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_get(txn, dbi_, &key_slice, &val_slice);
     if (res) {
         mdb_txn_abort(txn);
@@ -286,7 +293,6 @@ operation_result_t lmdb_t::batch_upsert(keys_spanc_t keys, values_spanc_t values
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
 
     size_t offset = 0;
     for (size_t idx = 0; idx < keys.size(); ++idx) {
@@ -317,7 +323,6 @@ operation_result_t lmdb_t::batch_read(keys_spanc_t keys, values_span_t values) c
     int res = mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
 
     // Note: imitation of batch read!
     size_t offset = 0;
@@ -338,8 +343,57 @@ operation_result_t lmdb_t::batch_read(keys_spanc_t keys, values_span_t values) c
 }
 
 operation_result_t lmdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
-    // Currently this DB doesn't have bulk upsert so instead we do batch upsert
-    return batch_upsert(keys, values, sizes);
+
+    // Keys of a single bulk are in strict ascending order, so with integer keys they can be appended
+    // to the end of the B+ tree without a lookup. Once another thread has appended bigger keys
+    // `MDB_APPEND` fails with `MDB_KEYEXIST`, and we fall back to regular inserts.
+    unsigned int put_flags = config_.integer_keys && config_.bulk_load_append ? MDB_APPEND : 0;
+    size_t txn_records = config_.bulk_load_txn_records ? config_.bulk_load_txn_records : keys.size();
+
+    size_t idx = 0;
+    size_t offset = 0;
+    while (idx != keys.size()) {
+        MDB_txn* txn = nullptr;
+        MDB_cursor* cursor = nullptr;
+
+        int res = mdb_txn_begin(env_, nullptr, 0, &txn);
+        if (res)
+            return {0, operation_status_t::error_k};
+        res = mdb_cursor_open(txn, dbi_, &cursor);
+        if (res) {
+            mdb_txn_abort(txn);
+            return {0, operation_status_t::error_k};
+        }
+
+        size_t txn_end = std::min(idx + txn_records, keys.size());
+        for (; idx != txn_end; ++idx) {
+            MDB_val key_slice, val_slice;
+            auto key = keys[idx];
+            key_slice.mv_data = &key;
+            key_slice.mv_size = sizeof(key_t);
+            val_slice.mv_data = const_cast<void*>(reinterpret_cast<void const*>(values.data() + offset));
+            val_slice.mv_size = sizes[idx];
+
+            res = mdb_cursor_put(cursor, &key_slice, &val_slice, put_flags);
+            if (res == MDB_KEYEXIST && put_flags) {
+                put_flags = 0;
+                res = mdb_cursor_put(cursor, &key_slice, &val_slice, put_flags);
+            }
+            if (res) {
+                mdb_cursor_close(cursor);
+                mdb_txn_abort(txn);
+                return {0, operation_status_t::error_k};
+            }
+            offset += sizes[idx];
+        }
+
+        mdb_cursor_close(cursor);
+        res = mdb_txn_commit(txn);
+        if (res)
+            return {0, operation_status_t::error_k};
+    }
+
+    return {keys.size(), operation_status_t::ok_k};
 }
 
 operation_result_t lmdb_t::range_select(key_t key, size_t length, values_span_t values) const {
@@ -354,7 +408,6 @@ operation_result_t lmdb_t::range_select(key_t key, size_t length, values_span_t
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_cursor_open(txn, dbi_, &cursor);
     if (res) {
         mdb_txn_abort(txn);
@@ -392,7 +445,6 @@ operation_result_t lmdb_t::scan(key_t key, size_t length, value_span_t single_va
     int res = mdb_txn_begin(env_, nullptr, 0, &txn);
     if (res)
         return {0, operation_status_t::error_k};
-    // mdb_set_compare(txn, &dbi_, compare_keys);
     res = mdb_cursor_open(txn, dbi_, &cursor);
     if (res) {
         mdb_txn_abort(txn);
@@ -419,12 +471,19 @@ operation_result_t lmdb_t::scan(key_t key, size_t length, value_span_t single_va
 std::string lmdb_t::info() { return fmt::format("v{}.{}.{}", MDB_VERSION_MAJOR, MDB_VERSION_MINOR, MDB_VERSION_PATCH); }
 
 void lmdb_t::flush() {
-    // Nothing to do
+    // With `no_sync` commits don't reach the disk, so optionally force it once per workload
+    if (config_.sync_on_flush)
+        mdb_env_sync(env_, 1);
 }
 
 size_t lmdb_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
 
-std::unique_ptr<transaction_t> lmdb_t::create_transaction() { return {}; }
+std::unique_ptr<transaction_t> lmdb_t::create_transaction() {
+    // There is a single writer lock, so a transaction of one thread, held across operations,
+    // would block the others up to the end of the workload, where they never reach the barrier
+    size_t commit_ops = hints_.threads_count > 1 ? 1 : config_.transaction_commit_ops;
+    return std::make_unique<lmdb_transaction_t>(env_, dbi_, commit_ops);
+}
 
 bool lmdb_t::load_config(config_t& config) {
     if (!fs::exists(config_path_))
@@ -439,6 +498,11 @@ bool lmdb_t::load_config(config_t& config) {
     config.no_meta_sync = j_config.value<bool>("no_meta_sync", false);
     config.no_read_a_head = j_config.value<bool>("no_read_a_head", false);
     config.write_map = j_config.value<bool>("write_map", false);
+    config.integer_keys = j_config.value<bool>("integer_keys", true);
+    config.bulk_load_txn_records = j_config.value<size_t>("bulk_load_txn_records", size_t(0));
+    config.bulk_load_append = j_config.value<bool>("bulk_load_append", true);
+    config.sync_on_flush = j_config.value<bool>("sync_on_flush", false);
+    config.transaction_commit_ops = j_config.value<size_t>("transaction_commit_ops", size_t(1'000));
 
     return true;
 }
@@ -0,0 +1,536 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <mdbx.h>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+
+#include "mdbx_transaction.hpp"
+
+namespace ucsb::erthink {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief libmdbx wrapper for the UCSB benchmark.
+ * Mirrors the LMDB one, but instead of a fixed map size the file follows
+ * the configured geometry, growing and shrinking in steps.
+ * https://gitflic.ru/project/erthink/libmdbx
+ */
+class mdbx_t : public ucsb::db_t {
+  public:
+    inline mdbx_t() : env_(nullptr), dbi_(0) {}
+    ~mdbx_t() { close(); }
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    /**
+     * @brief Arguments of `mdbx_env_set_geometry`, all in bytes.
+     * Negative values keep the library defaults.
+     */
+    struct geometry_t {
+        intptr_t size_lower = -1;
+        intptr_t size_now = -1;
+        intptr_t size_upper = -1;
+        intptr_t growth_step = -1;
+        intptr_t shrink_threshold = -1;
+        intptr_t page_size = -1;
+    };
+
+    struct config_t {
+        geometry_t geometry;
+        MDBX_env_flags_t sync_mode = MDBX_SAFE_NOSYNC;
+        bool no_read_a_head = false;
+        bool write_map = false;
+        bool lifo_reclaim = false;
+        bool integer_keys = true;
+
+        /**
+         * @brief Records committed per write transaction during `bulk_load`.
+         * Zero means the whole bulk goes into a single transaction.
+         */
+        size_t bulk_load_txn_records = 0;
+        bool bulk_load_append = true;
+        bool sync_on_flush = false;
+        size_t transaction_commit_ops = 0;
+    };
+
+    bool load_config(config_t& config);
+
+    fs::path config_path_;
+    fs::path main_dir_path_;
+    std::vector<fs::path> storage_dir_paths_;
+    db_hints_t hints_;
+    config_t config_;
+
+    MDBX_env* env_;
+    MDBX_dbi dbi_;
+};
+
+void mdbx_t::set_config(fs::path const& config_path,
+                        fs::path const& main_dir_path,
+                        std::vector<fs::path> const& storage_dir_paths,
+                        db_hints_t const& hints) {
+    config_path_ = config_path;
+    main_dir_path_ = main_dir_path;
+    storage_dir_paths_ = storage_dir_paths;
+    hints_ = hints;
+}
+
+bool mdbx_t::open(std::string& error) {
+    if (env_)
+        return true;
+
+    if (!storage_dir_paths_.empty()) {
+        error = "Doesn't support multiple disks";
+        return false;
+    }
+
+    if (!load_config(config_)) {
+        error = "Failed to load config";
+        return false;
+    }
+
+    int env_opt = config_.sync_mode;
+    if (config_.no_read_a_head)
+        env_opt |= MDBX_NORDAHEAD;
+    if (config_.write_map)
+        env_opt |= MDBX_WRITEMAP;
+    if (config_.lifo_reclaim)
+        env_opt |= MDBX_LIFORECLAIM;
+
+    int res = mdbx_env_create(&env_);
+    if (res) {
+        error = "Failed to create environment";
+        return false;
+    }
+    auto const& geometry = config_.geometry;
+    res = mdbx_env_set_geometry(env_,
+                                geometry.size_lower,
+                                geometry.size_now,
+                                geometry.size_upper,
+                                geometry.growth_step,
+                                geometry.shrink_threshold,
+                                geometry.page_size);
+    if (res) {
+        close();
+        error = "Failed to apply config";
+        return false;
+    }
+
+    res = mdbx_env_open(env_, main_dir_path_.c_str(), MDBX_env_flags_t(env_opt), 0664);
+    if (res) {
+        close();
+        error = "Failed to open environment";
+        return false;
+    }
+
+    MDBX_txn* txn;
+    res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (res) {
+        close();
+        error = "Failed to begin transaction";
+        return false;
+    }
+    // Same as with LMDB, `MDBX_INTEGERKEY` keeps native little-endian keys in numeric order
+    int dbi_opt = MDBX_CREATE | (config_.integer_keys ? MDBX_INTEGERKEY : 0);
+    res = mdbx_dbi_open(txn, nullptr, MDBX_db_flags_t(dbi_opt), &dbi_);
+    if (res) {
+        mdbx_txn_abort(txn);
+        close();
+        error = "Failed to open DB";
+        return false;
+    }
+    res = mdbx_txn_commit(txn);
+    if (res) {
+        close();
+        error = "Failed to commit transaction";
+        return false;
+    }
+
+    return true;
+}
+
+void mdbx_t::close() {
+    if (!env_)
+        return;
+
+    if (dbi_)
+        mdbx_dbi_close(env_, dbi_);
+    mdbx_env_close(env_);
+    dbi_ = 0;
+    env_ = nullptr;
+}
+
+operation_result_t mdbx_t::upsert(key_t key, value_spanc_t value) {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(value.data()));
+    val_slice.iov_len = value.size();
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    res = mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_UPSERT);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, operation_status_t::error_k};
+    }
+    res = mdbx_txn_commit(txn);
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_t::update(key_t key, value_spanc_t value) {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(value.data()));
+    val_slice.iov_len = value.size();
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    // `MDBX_CURRENT` only overwrites existing entries, so no separate lookup is needed
+    res = mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_CURRENT);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, res == MDBX_NOTFOUND ? operation_status_t::not_found_k : operation_status_t::error_k};
+    }
+
+    res = mdbx_txn_commit(txn);
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_t::remove(key_t key) {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_val key_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    res = mdbx_del(txn, dbi_, &key_slice, nullptr);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, res == MDBX_NOTFOUND ? operation_status_t::not_found_k : operation_status_t::error_k};
+    }
+    res = mdbx_txn_commit(txn);
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_t::read(key_t key, value_span_t value) const {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_RDONLY, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    res = mdbx_get(txn, dbi_, &key_slice, &val_slice);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, operation_status_t::not_found_k};
+    }
+    memcpy(value.data(), val_slice.iov_base, val_slice.iov_len);
+    mdbx_txn_abort(txn);
+
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t mdbx_t::batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+
+    MDBX_txn* txn = nullptr;
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+
+    size_t offset = 0;
+    for (size_t idx = 0; idx < keys.size(); ++idx) {
+        MDBX_val key_slice, val_slice;
+        auto key = keys[idx];
+        key_slice.iov_base = &key;
+        key_slice.iov_len = sizeof(key_t);
+        val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(values.data() + offset));
+        val_slice.iov_len = sizes[idx];
+
+        res = mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_UPSERT);
+        if (res) {
+            mdbx_txn_abort(txn);
+            return {0, operation_status_t::error_k};
+        }
+        offset += sizes[idx];
+    }
+
+    res = mdbx_txn_commit(txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t mdbx_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_RDONLY, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+
+    // Note: imitation of batch read!
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key : keys) {
+        key_slice.iov_base = &key;
+        key_slice.iov_len = sizeof(key_t);
+        res = mdbx_get(txn, dbi_, &key_slice, &val_slice);
+        if (res == 0) {
+            memcpy(values.data() + offset, val_slice.iov_base, val_slice.iov_len);
+            offset += val_slice.iov_len;
+            ++found_cnt;
+        }
+    }
+
+    mdbx_txn_abort(txn);
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t mdbx_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+
+    // Just like in LMDB, sorted integer keys are appended to the end of the tree without a lookup.
+    // Once another thread has appended bigger keys, `MDBX_APPEND` fails with `MDBX_EKEYMISMATCH`,
+    // and we fall back to regular inserts.
+    MDBX_put_flags_t put_flags = config_.integer_keys && config_.bulk_load_append ? MDBX_APPEND : MDBX_UPSERT;
+    size_t txn_records = config_.bulk_load_txn_records ? config_.bulk_load_txn_records : keys.size();
+
+    size_t idx = 0;
+    size_t offset = 0;
+    while (idx != keys.size()) {
+        MDBX_txn* txn = nullptr;
+        MDBX_cursor* cursor = nullptr;
+
+        int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &txn);
+        if (res)
+            return {0, operation_status_t::error_k};
+        res = mdbx_cursor_open(txn, dbi_, &cursor);
+        if (res) {
+            mdbx_txn_abort(txn);
+            return {0, operation_status_t::error_k};
+        }
+
+        size_t txn_end = std::min(idx + txn_records, keys.size());
+        for (; idx != txn_end; ++idx) {
+            MDBX_val key_slice, val_slice;
+            auto key = keys[idx];
+            key_slice.iov_base = &key;
+            key_slice.iov_len = sizeof(key_t);
+            val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(values.data() + offset));
+            val_slice.iov_len = sizes[idx];
+
+            res = mdbx_cursor_put(cursor, &key_slice, &val_slice, put_flags);
+            if ((res == MDBX_EKEYMISMATCH || res == MDBX_KEYEXIST) && put_flags == MDBX_APPEND) {
+                put_flags = MDBX_UPSERT;
+                res = mdbx_cursor_put(cursor, &key_slice, &val_slice, put_flags);
+            }
+            if (res) {
+                mdbx_cursor_close(cursor);
+                mdbx_txn_abort(txn);
+                return {0, operation_status_t::error_k};
+            }
+            offset += sizes[idx];
+        }
+
+        mdbx_cursor_close(cursor);
+        res = mdbx_txn_commit(txn);
+        if (res)
+            return {0, operation_status_t::error_k};
+    }
+
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t mdbx_t::range_select(key_t key, size_t length, values_span_t values) const {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_cursor* cursor = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_RDONLY, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    res = mdbx_cursor_open(txn, dbi_, &cursor);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, operation_status_t::error_k};
+    }
+    res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_SET_RANGE);
+
+    size_t offset = 0;
+    size_t selected_records_count = 0;
+    for (; res == 0 && selected_records_count != length; ++selected_records_count) {
+        memcpy(values.data() + offset, val_slice.iov_base, val_slice.iov_len);
+        offset += val_slice.iov_len;
+        res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_NEXT);
+    }
+
+    mdbx_cursor_close(cursor);
+    mdbx_txn_abort(txn);
+    return {selected_records_count,
+            selected_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+operation_result_t mdbx_t::scan(key_t key, size_t length, value_span_t single_value) const {
+
+    MDBX_txn* txn = nullptr;
+    MDBX_cursor* cursor = nullptr;
+    MDBX_val key_slice, val_slice;
+
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_txn_begin(env_, nullptr, MDBX_TXN_RDONLY, &txn);
+    if (res)
+        return {0, operation_status_t::error_k};
+    res = mdbx_cursor_open(txn, dbi_, &cursor);
+    if (res) {
+        mdbx_txn_abort(txn);
+        return {0, operation_status_t::error_k};
+    }
+    res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_SET_RANGE);
+
+    size_t scanned_records_count = 0;
+    for (; res == 0 && scanned_records_count != length; ++scanned_records_count) {
+        memcpy(single_value.data(), val_slice.iov_base, val_slice.iov_len);
+        res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_NEXT);
+    }
+
+    mdbx_cursor_close(cursor);
+    mdbx_txn_abort(txn);
+    return {scanned_records_count,
+            scanned_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+std::string mdbx_t::info() {
+    return fmt::format("v{}.{}.{}", mdbx_version.major, mdbx_version.minor, mdbx_version.release);
+}
+
+void mdbx_t::flush() {
+    // Without durable sync mode commits don't reach the disk, so optionally force it once per workload
+    if (config_.sync_on_flush)
+        mdbx_env_sync_ex(env_, true, false);
+}
+
+size_t mdbx_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
+
+std::unique_ptr<transaction_t> mdbx_t::create_transaction() {
+    // Same single writer lock, as in LMDB, so many threads commit after every operation
+    size_t commit_ops = hints_.threads_count > 1 ? 1 : config_.transaction_commit_ops;
+    return std::make_unique<mdbx_transaction_t>(env_, dbi_, commit_ops);
+}
+
+bool mdbx_t::load_config(config_t& config) {
+    if (!fs::exists(config_path_))
+        return false;
+
+    std::ifstream i_config(config_path_);
+    nlohmann::json j_config;
+    i_config >> j_config;
+
+    auto j_geometry = j_config.value("geometry", nlohmann::json::object());
+    config.geometry.size_lower = j_geometry.value<intptr_t>("size_lower", -1);
+    config.geometry.size_now = j_geometry.value<intptr_t>("size_now", -1);
+    config.geometry.size_upper = j_geometry.value<intptr_t>("size_upper", -1);
+    config.geometry.growth_step = j_geometry.value<intptr_t>("growth_step", -1);
+    config.geometry.shrink_threshold = j_geometry.value<intptr_t>("shrink_threshold", -1);
+    config.geometry.page_size = j_geometry.value<intptr_t>("page_size", -1);
+
+    auto sync_mode = j_config.value<std::string>("sync_mode", "safe_nosync");
+    if (sync_mode == "durable")
+        config.sync_mode = MDBX_SYNC_DURABLE;
+    else if (sync_mode == "no_meta_sync")
+        config.sync_mode = MDBX_NOMETASYNC;
+    else if (sync_mode == "safe_nosync")
+        config.sync_mode = MDBX_SAFE_NOSYNC;
+    else if (sync_mode == "utterly_nosync")
+        config.sync_mode = MDBX_UTTERLY_NOSYNC;
+    else
+        return false;
+
+    config.no_read_a_head = j_config.value<bool>("no_read_a_head", false);
+    config.write_map = j_config.value<bool>("write_map", false);
+    config.lifo_reclaim = j_config.value<bool>("lifo_reclaim", false);
+    config.integer_keys = j_config.value<bool>("integer_keys", true);
+    config.bulk_load_txn_records = j_config.value<size_t>("bulk_load_txn_records", size_t(0));
+    config.bulk_load_append = j_config.value<bool>("bulk_load_append", true);
+    config.sync_on_flush = j_config.value<bool>("sync_on_flush", false);
+    config.transaction_commit_ops = j_config.value<size_t>("transaction_commit_ops", size_t(1'000));
+
+    return true;
+}
+
+} // namespace ucsb::erthink
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <cstring>
+#include <algorithm>
+
+#include <mdbx.h>
+
+#include "src/core/types.hpp"
+#include "src/core/data_accessor.hpp"
+
+namespace ucsb::erthink {
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+
+/**
+ * @brief libmdbx transactional wrapper for the UCSB benchmark.
+ * Same scheme as for LMDB: writes accumulate in a lazily started write transaction,
+ * committed every `commit_ops` operations, or after every operation in multi-threaded runs,
+ * while reads are served from a reusable read-only transaction until the first write.
+ */
+class mdbx_transaction_t : public ucsb::transaction_t {
+  public:
+    inline mdbx_transaction_t(MDBX_env* env, MDBX_dbi dbi, size_t commit_ops)
+        : env_(env), dbi_(dbi), commit_ops_(std::max(commit_ops, size_t(1))), write_txn_(nullptr),
+          read_txn_(nullptr), uncommitted_ops_(0) {}
+    ~mdbx_transaction_t();
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+  private:
+    MDBX_txn* begin_write();
+    bool end_write(size_t ops);
+    void abort_write();
+    MDBX_txn* begin_read() const;
+    void end_read() const;
+
+    MDBX_env* env_;
+    MDBX_dbi dbi_;
+    size_t commit_ops_;
+
+    MDBX_txn* write_txn_;
+    mutable MDBX_txn* read_txn_;
+    size_t uncommitted_ops_;
+};
+
+mdbx_transaction_t::~mdbx_transaction_t() {
+    if (write_txn_)
+        mdbx_txn_commit(write_txn_);
+    if (read_txn_)
+        mdbx_txn_abort(read_txn_);
+}
+
+MDBX_txn* mdbx_transaction_t::begin_write() {
+    if (write_txn_)
+        return write_txn_;
+
+    // A thread may only have a single transaction at a time
+    if (read_txn_) {
+        mdbx_txn_abort(read_txn_);
+        read_txn_ = nullptr;
+    }
+    if (mdbx_txn_begin(env_, nullptr, MDBX_TXN_READWRITE, &write_txn_))
+        write_txn_ = nullptr;
+    return write_txn_;
+}
+
+bool mdbx_transaction_t::end_write(size_t ops) {
+    uncommitted_ops_ += ops;
+    if (uncommitted_ops_ && uncommitted_ops_ < commit_ops_)
+        return true;
+
+    int res = mdbx_txn_commit(write_txn_);
+    write_txn_ = nullptr;
+    uncommitted_ops_ = 0;
+    return res == 0;
+}
+
+void mdbx_transaction_t::abort_write() {
+    mdbx_txn_abort(write_txn_);
+    write_txn_ = nullptr;
+    uncommitted_ops_ = 0;
+}
+
+MDBX_txn* mdbx_transaction_t::begin_read() const {
+    if (write_txn_)
+        return write_txn_;
+
+    // Renewing a reset transaction is cheaper, than starting a new one
+    if (read_txn_) {
+        if (mdbx_txn_renew(read_txn_) == 0)
+            return read_txn_;
+        mdbx_txn_abort(read_txn_);
+        read_txn_ = nullptr;
+    }
+    if (mdbx_txn_begin(env_, nullptr, MDBX_TXN_RDONLY, &read_txn_))
+        read_txn_ = nullptr;
+    return read_txn_;
+}
+
+void mdbx_transaction_t::end_read() const {
+    if (!write_txn_ && read_txn_)
+        mdbx_txn_reset(read_txn_);
+}
+
+operation_result_t mdbx_transaction_t::upsert(key_t key, value_spanc_t value) {
+    MDBX_txn* txn = begin_write();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_val key_slice, val_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+    val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(value.data()));
+    val_slice.iov_len = value.size();
+
+    if (mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_UPSERT)) {
+        abort_write();
+        return {0, operation_status_t::error_k};
+    }
+
+    bool committed = end_write(1);
+    return {size_t(committed), committed ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_transaction_t::update(key_t key, value_spanc_t value) {
+    MDBX_txn* txn = begin_write();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_val key_slice, val_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+    val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(value.data()));
+    val_slice.iov_len = value.size();
+
+    int res = mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_CURRENT);
+    if (res == MDBX_NOTFOUND) {
+        end_write(0);
+        return {0, operation_status_t::not_found_k};
+    }
+    if (res) {
+        abort_write();
+        return {0, operation_status_t::error_k};
+    }
+
+    bool committed = end_write(1);
+    return {size_t(committed), committed ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_transaction_t::remove(key_t key) {
+    MDBX_txn* txn = begin_write();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_val key_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_del(txn, dbi_, &key_slice, nullptr);
+    if (res == MDBX_NOTFOUND) {
+        end_write(0);
+        return {0, operation_status_t::not_found_k};
+    }
+    if (res) {
+        abort_write();
+        return {0, operation_status_t::error_k};
+    }
+
+    bool committed = end_write(1);
+    return {size_t(committed), committed ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_transaction_t::read(key_t key, value_span_t value) const {
+    MDBX_txn* txn = begin_read();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_val key_slice, val_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+
+    int res = mdbx_get(txn, dbi_, &key_slice, &val_slice);
+    if (res == 0)
+        memcpy(value.data(), val_slice.iov_base, val_slice.iov_len);
+    end_read();
+
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+operation_result_t mdbx_transaction_t::batch_upsert(keys_spanc_t keys,
+                                                    values_spanc_t values,
+                                                    value_lengths_spanc_t sizes) {
+    MDBX_txn* txn = begin_write();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    size_t offset = 0;
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        MDBX_val key_slice, val_slice;
+        auto key = keys[idx];
+        key_slice.iov_base = &key;
+        key_slice.iov_len = sizeof(key_t);
+        val_slice.iov_base = const_cast<void*>(reinterpret_cast<void const*>(values.data() + offset));
+        val_slice.iov_len = sizes[idx];
+
+        if (mdbx_put(txn, dbi_, &key_slice, &val_slice, MDBX_UPSERT)) {
+            abort_write();
+            return {0, operation_status_t::error_k};
+        }
+        offset += sizes[idx];
+    }
+
+    bool committed = end_write(keys.size());
+    return {committed ? keys.size() : 0, committed ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t mdbx_transaction_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    MDBX_txn* txn = begin_read();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key : keys) {
+        MDBX_val key_slice, val_slice;
+        key_slice.iov_base = &key;
+        key_slice.iov_len = sizeof(key_t);
+        if (mdbx_get(txn, dbi_, &key_slice, &val_slice) == 0) {
+            memcpy(values.data() + offset, val_slice.iov_base, val_slice.iov_len);
+            offset += val_slice.iov_len;
+            ++found_cnt;
+        }
+    }
+    end_read();
+
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t mdbx_transaction_t::bulk_load(keys_spanc_t keys,
+                                                 values_spanc_t values,
+                                                 value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t mdbx_transaction_t::range_select(key_t key, size_t length, values_span_t values) const {
+    MDBX_txn* txn = begin_read();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_cursor* cursor = nullptr;
+    if (mdbx_cursor_open(txn, dbi_, &cursor)) {
+        end_read();
+        return {0, operation_status_t::error_k};
+    }
+
+    MDBX_val key_slice, val_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+    int res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_SET_RANGE);
+
+    size_t offset = 0;
+    size_t selected_records_count = 0;
+    for (; res == 0 && selected_records_count != length; ++selected_records_count) {
+        memcpy(values.data() + offset, val_slice.iov_base, val_slice.iov_len);
+        offset += val_slice.iov_len;
+        res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_NEXT);
+    }
+
+    mdbx_cursor_close(cursor);
+    end_read();
+    return {selected_records_count,
+            selected_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+operation_result_t mdbx_transaction_t::scan(key_t key, size_t length, value_span_t single_value) const {
+    MDBX_txn* txn = begin_read();
+    if (!txn)
+        return {0, operation_status_t::error_k};
+
+    MDBX_cursor* cursor = nullptr;
+    if (mdbx_cursor_open(txn, dbi_, &cursor)) {
+        end_read();
+        return {0, operation_status_t::error_k};
+    }
+
+    MDBX_val key_slice, val_slice;
+    key_slice.iov_base = &key;
+    key_slice.iov_len = sizeof(key_t);
+    int res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_SET_RANGE);
+
+    size_t scanned_records_count = 0;
+    for (; res == 0 && scanned_records_count != length; ++scanned_records_count) {
+        memcpy(single_value.data(), val_slice.iov_base, val_slice.iov_len);
+        res = mdbx_cursor_get(cursor, &key_slice, &val_slice, MDBX_NEXT);
+    }
+
+    mdbx_cursor_close(cursor);
+    end_read();
+    return {scanned_records_count,
+            scanned_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+} // namespace ucsb::erthink
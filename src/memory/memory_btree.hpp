@@ -0,0 +1,447 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+
+namespace ucsb::memory {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief In-memory B+tree, the ordered counterpart of `memory_hash_t`.
+ * A reference engine without any persistence: it shows the throughput ceiling
+ * of the harness itself for range selects and scans on the same machine.
+ *
+ * Every node has its own reader-writer latch, coupled on the way down. Writers latch
+ * the inner nodes shared and only the leaf exclusively, unless it's full, then they
+ * retry with exclusive latches, splitting full nodes top-down. A separate lock guards
+ * the root pointer. Leaves are linked, so ranges never go back to the root and couple
+ * latches from leaf to leaf, which is the same direction, as splits go in.
+ * Removals don't rebalance the tree, emptied leaves stay linked and get refilled later.
+ * Doesn't need a config. The data survives `close`, but isn't shared with reader processes.
+ */
+class memory_btree_t : public ucsb::db_t {
+  public:
+    inline memory_btree_t() : root_(std::make_unique<leaf_t>()) {}
+    ~memory_btree_t() = default;
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    static constexpr size_t leaf_capacity_k = 64;
+    static constexpr size_t inner_capacity_k = 64;
+
+    struct node_t {
+        inline node_t(bool leaf) : is_leaf(leaf) {}
+        virtual ~node_t() = default;
+
+        bool is_leaf;
+        size_t count = 0;
+        mutable std::shared_mutex latch;
+    };
+
+    struct leaf_t : public node_t {
+        inline leaf_t() : node_t(true) {}
+
+        std::array<key_t, leaf_capacity_k> keys;
+        std::array<std::string, leaf_capacity_k> values;
+        leaf_t* next = nullptr;
+    };
+
+    /**
+     * @brief Holds `count` separators and `count + 1` children.
+     * Keys equal to a separator belong to the child on its right.
+     */
+    struct inner_t : public node_t {
+        inline inner_t() : node_t(false) {}
+
+        std::array<key_t, inner_capacity_k> keys;
+        std::array<std::unique_ptr<node_t>, inner_capacity_k + 1> children;
+    };
+
+    static inline bool is_full(node_t const& node) {
+        return node.count == (node.is_leaf ? leaf_capacity_k : inner_capacity_k);
+    }
+    static inline size_t child_idx(inner_t const& inner, key_t key) {
+        return std::upper_bound(inner.keys.begin(), inner.keys.begin() + inner.count, key) - inner.keys.begin();
+    }
+    static inline size_t key_idx(leaf_t const& leaf, key_t key) {
+        return std::lower_bound(leaf.keys.begin(), leaf.keys.begin() + leaf.count, key) - leaf.keys.begin();
+    }
+
+    /**
+     * @brief Return the leaf of the `key`, latched shared or exclusively, whichever is named.
+     * The caller releases the latch.
+     */
+    leaf_t* lock_leaf_shared(key_t key) const;
+    leaf_t* lock_leaf_exclusive(key_t key) const;
+    leaf_t* lock_leaf_for_insert(key_t key);
+    static leaf_t* next_leaf_shared(leaf_t* leaf);
+
+    static std::string* find_value(leaf_t& leaf, key_t key);
+    static std::string& insert(leaf_t& leaf, key_t key);
+    void upsert_one(key_t key, char const* data, size_t size);
+    void split_child(inner_t& parent, size_t idx);
+
+    std::unique_ptr<node_t> root_;
+    mutable std::shared_mutex root_mutex_;
+};
+
+void memory_btree_t::set_config([[maybe_unused]] fs::path const& config_path,
+                                [[maybe_unused]] fs::path const& main_dir_path,
+                                [[maybe_unused]] std::vector<fs::path> const& storage_dir_paths,
+                                [[maybe_unused]] db_hints_t const& hints) {
+}
+
+bool memory_btree_t::open([[maybe_unused]] std::string& error) { return true; }
+
+void memory_btree_t::close() {
+    // Nothing to flush, the data is kept for the next workload
+}
+
+std::string memory_btree_t::info() { return fmt::format("in-memory, B+tree of {} keys per leaf", leaf_capacity_k); }
+
+memory_btree_t::leaf_t* memory_btree_t::lock_leaf_shared(key_t key) const {
+    std::shared_lock root_lock(root_mutex_);
+    node_t* node = root_.get();
+    node->latch.lock_shared();
+    root_lock.unlock();
+
+    // A child is latched before its parent is released, so no split can slip in between
+    while (!node->is_leaf) {
+        auto inner = static_cast<inner_t*>(node);
+        node_t* child = inner->children[child_idx(*inner, key)].get();
+        child->latch.lock_shared();
+        inner->latch.unlock_shared();
+        node = child;
+    }
+    return static_cast<leaf_t*>(node);
+}
+
+memory_btree_t::leaf_t* memory_btree_t::lock_leaf_exclusive(key_t key) const {
+    // Only the leaf changes, so the inner nodes are latched shared, like for reads
+    std::shared_lock root_lock(root_mutex_);
+    node_t* node = root_.get();
+    if (node->is_leaf) {
+        node->latch.lock();
+        return static_cast<leaf_t*>(node);
+    }
+    node->latch.lock_shared();
+    root_lock.unlock();
+
+    while (true) {
+        auto inner = static_cast<inner_t*>(node);
+        node_t* child = inner->children[child_idx(*inner, key)].get();
+        if (child->is_leaf) {
+            child->latch.lock();
+            inner->latch.unlock_shared();
+            return static_cast<leaf_t*>(child);
+        }
+        child->latch.lock_shared();
+        inner->latch.unlock_shared();
+        node = child;
+    }
+}
+
+memory_btree_t::leaf_t* memory_btree_t::lock_leaf_for_insert(key_t key) {
+    // Full nodes are split on the way down, so a split never propagates upwards
+    // and a parent is released as soon as its child is latched and isn't full
+    std::unique_lock root_lock(root_mutex_);
+    node_t* node = root_.get();
+    node->latch.lock();
+    if (is_full(*node)) {
+        auto root = std::make_unique<inner_t>();
+        root->children[0] = std::move(root_);
+        split_child(*root, 0);
+        root_ = std::move(root);
+
+        // The new root is only reachable under the root lock, so it needs no latch
+        auto inner = static_cast<inner_t*>(root_.get());
+        node_t* child = inner->children[child_idx(*inner, key)].get();
+        if (child != node) {
+            child->latch.lock();
+            node->latch.unlock();
+        }
+        node = child;
+    }
+    root_lock.unlock();
+
+    while (!node->is_leaf) {
+        auto inner = static_cast<inner_t*>(node);
+        size_t idx = child_idx(*inner, key);
+        node_t* child = inner->children[idx].get();
+        child->latch.lock();
+        if (is_full(*child)) {
+            split_child(*inner, idx);
+            // The new sibling is only reachable through the latched nodes
+            node_t* target = inner->children[child_idx(*inner, key)].get();
+            if (target != child) {
+                target->latch.lock();
+                child->latch.unlock();
+            }
+            child = target;
+        }
+        inner->latch.unlock();
+        node = child;
+    }
+    return static_cast<leaf_t*>(node);
+}
+
+memory_btree_t::leaf_t* memory_btree_t::next_leaf_shared(leaf_t* leaf) {
+    leaf_t* next = leaf->next;
+    if (next)
+        next->latch.lock_shared();
+    leaf->latch.unlock_shared();
+    return next;
+}
+
+std::string* memory_btree_t::find_value(leaf_t& leaf, key_t key) {
+    size_t idx = key_idx(leaf, key);
+    if (idx == leaf.count || leaf.keys[idx] != key)
+        return nullptr;
+    return &leaf.values[idx];
+}
+
+std::string& memory_btree_t::insert(leaf_t& leaf, key_t key) {
+    size_t idx = key_idx(leaf, key);
+    if (idx != leaf.count && leaf.keys[idx] == key)
+        return leaf.values[idx];
+
+    for (size_t i = leaf.count; i != idx; --i) {
+        leaf.keys[i] = leaf.keys[i - 1];
+        leaf.values[i] = std::move(leaf.values[i - 1]);
+    }
+    leaf.keys[idx] = key;
+    ++leaf.count;
+    return leaf.values[idx];
+}
+
+void memory_btree_t::upsert_one(key_t key, char const* data, size_t size) {
+    // Most inserts fit into their leaf, the rest retry with splits on the way down
+    leaf_t* leaf = lock_leaf_exclusive(key);
+    if (is_full(*leaf) && !find_value(*leaf, key)) {
+        leaf->latch.unlock();
+        leaf = lock_leaf_for_insert(key);
+    }
+    std::unique_lock lock(leaf->latch, std::adopt_lock);
+    insert(*leaf, key).assign(data, size);
+}
+
+void memory_btree_t::split_child(inner_t& parent, size_t idx) {
+    node_t& child = *parent.children[idx];
+    key_t separator = 0;
+    std::unique_ptr<node_t> sibling;
+    if (child.is_leaf) {
+        auto& leaf = static_cast<leaf_t&>(child);
+        auto right = std::make_unique<leaf_t>();
+        size_t half = leaf.count / 2;
+        right->count = leaf.count - half;
+        for (size_t i = 0; i != right->count; ++i) {
+            right->keys[i] = leaf.keys[half + i];
+            right->values[i] = std::move(leaf.values[half + i]);
+        }
+        leaf.count = half;
+        right->next = leaf.next;
+        leaf.next = right.get();
+        separator = right->keys[0];
+        sibling = std::move(right);
+    }
+    else {
+        auto& inner = static_cast<inner_t&>(child);
+        auto right = std::make_unique<inner_t>();
+        size_t half = inner.count / 2;
+        separator = inner.keys[half];
+        right->count = inner.count - half - 1;
+        for (size_t i = 0; i != right->count; ++i)
+            right->keys[i] = inner.keys[half + 1 + i];
+        for (size_t i = 0; i != right->count + 1; ++i)
+            right->children[i] = std::move(inner.children[half + 1 + i]);
+        inner.count = half;
+        sibling = std::move(right);
+    }
+
+    for (size_t i = parent.count; i != idx; --i) {
+        parent.keys[i] = parent.keys[i - 1];
+        parent.children[i + 1] = std::move(parent.children[i]);
+    }
+    parent.keys[idx] = separator;
+    parent.children[idx + 1] = std::move(sibling);
+    ++parent.count;
+}
+
+operation_result_t memory_btree_t::upsert(key_t key, value_spanc_t value) {
+    upsert_one(key, reinterpret_cast<char const*>(value.data()), value.size());
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::update(key_t key, value_spanc_t value) {
+    leaf_t* leaf = lock_leaf_exclusive(key);
+    std::unique_lock lock(leaf->latch, std::adopt_lock);
+    std::string* data = find_value(*leaf, key);
+    if (!data)
+        return {0, operation_status_t::not_found_k};
+
+    data->assign(reinterpret_cast<char const*>(value.data()), value.size());
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::remove(key_t key) {
+    leaf_t* leaf = lock_leaf_exclusive(key);
+    std::unique_lock lock(leaf->latch, std::adopt_lock);
+    size_t idx = key_idx(*leaf, key);
+    if (idx == leaf->count || leaf->keys[idx] != key)
+        return {0, operation_status_t::not_found_k};
+
+    for (size_t i = idx; i + 1 != leaf->count; ++i) {
+        leaf->keys[i] = leaf->keys[i + 1];
+        leaf->values[i] = std::move(leaf->values[i + 1]);
+    }
+    --leaf->count;
+    std::string().swap(leaf->values[leaf->count]);
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::read(key_t key, value_span_t value) const {
+    leaf_t* leaf = lock_leaf_shared(key);
+    std::shared_lock lock(leaf->latch, std::adopt_lock);
+    std::string const* data = find_value(*leaf, key);
+    if (!data)
+        return {0, operation_status_t::not_found_k};
+
+    memcpy(value.data(), data->data(), data->size());
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::batch_upsert(keys_spanc_t keys,
+                                                values_spanc_t values,
+                                                value_lengths_spanc_t sizes) {
+    // Every key is latched on its own, so the batch isn't atomic, just like in most engines
+    size_t offset = 0;
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        upsert_one(keys[idx], reinterpret_cast<char const*>(values.data() + offset), sizes[idx]);
+        offset += sizes[idx];
+    }
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key : keys) {
+        leaf_t* leaf = lock_leaf_shared(key);
+        std::shared_lock lock(leaf->latch, std::adopt_lock);
+        std::string const* data = find_value(*leaf, key);
+        if (!data)
+            continue;
+        memcpy(values.data() + offset, data->data(), data->size());
+        offset += data->size();
+        ++found_cnt;
+    }
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t memory_btree_t::range_select(key_t key, size_t length, values_span_t values) const {
+    leaf_t* leaf = lock_leaf_shared(key);
+    size_t idx = key_idx(*leaf, key);
+    size_t i = 0;
+    size_t exported_bytes = 0;
+    while (leaf && i != length) {
+        if (idx == leaf->count) {
+            leaf = next_leaf_shared(leaf);
+            idx = 0;
+            continue;
+        }
+        std::string const& data = leaf->values[idx];
+        memcpy(values.data() + exported_bytes, data.data(), data.size());
+        exported_bytes += data.size();
+        ++idx;
+        ++i;
+    }
+    if (leaf)
+        leaf->latch.unlock_shared();
+    return {i, operation_status_t::ok_k};
+}
+
+operation_result_t memory_btree_t::scan(key_t key, size_t length, value_span_t single_value) const {
+    leaf_t* leaf = lock_leaf_shared(key);
+    size_t idx = key_idx(*leaf, key);
+    size_t i = 0;
+    while (leaf && i != length) {
+        if (idx == leaf->count) {
+            leaf = next_leaf_shared(leaf);
+            idx = 0;
+            continue;
+        }
+        std::string const& data = leaf->values[idx];
+        memcpy(single_value.data(), data.data(), data.size());
+        ++idx;
+        ++i;
+    }
+    if (leaf)
+        leaf->latch.unlock_shared();
+    return {i, operation_status_t::ok_k};
+}
+
+void memory_btree_t::flush() {
+    // Nothing to flush
+}
+
+size_t memory_btree_t::size_on_disk() const { return 0; }
+
+std::unique_ptr<transaction_t> memory_btree_t::create_transaction() { return {}; }
+
+} // namespace ucsb::memory
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+
+namespace ucsb::memory {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief Sharded open-addressing hash map, which keeps everything in RAM.
+ * A reference engine without any persistence: it shows the throughput ceiling
+ * of the harness itself for point operations on the same machine.
+ *
+ * Every shard is a linear probing table behind its own reader-writer lock.
+ * There is no order of keys, so range selects probe consecutive keys, which
+ * matches the dense integer keys of UCSB, and scans walk the tables in storage order.
+ * The data survives `close`, so the workloads of a run build on each other,
+ * but it is never shared with reader processes.
+ */
+class memory_hash_t : public ucsb::db_t {
+  public:
+    inline memory_hash_t() = default;
+    ~memory_hash_t() = default;
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    struct config_t {
+        size_t shards_count = 64;
+        float max_load_factor = 0.5;
+    };
+
+    enum class slot_state_t : uint8_t {
+        empty_k,
+        full_k,
+        removed_k,
+    };
+
+    struct slot_t {
+        key_t key = 0;
+        slot_state_t state = slot_state_t::empty_k;
+        std::string value;
+    };
+
+    struct alignas(64) shard_t {
+        mutable std::shared_mutex mutex;
+        std::vector<slot_t> slots;
+        /**
+         * @brief Slots, holding values, and the ones, which ever did.
+         * Removed slots still break probing sequences, until the next rehash.
+         */
+        size_t full_count = 0;
+        size_t used_count = 0;
+    };
+
+    bool load_config(config_t& config);
+
+    static inline uint64_t hash(key_t key);
+    inline shard_t& shard(uint64_t hash) const { return shards_[(hash >> 32) & (shards_count_ - 1)]; }
+
+    static slot_t* find(shard_t& shard, key_t key, uint64_t hash);
+    slot_t& find_or_insert(shard_t& shard, key_t key, uint64_t hash);
+    void rehash(shard_t& shard, size_t capacity);
+    bool copy_value(key_t key, std::byte* target) const;
+    void upsert_value(key_t key, value_spanc_t value);
+
+    fs::path config_path_;
+    db_hints_t hints_;
+    config_t config_;
+
+    std::unique_ptr<shard_t[]> shards_;
+    size_t shards_count_ = 0;
+};
+
+void memory_hash_t::set_config(fs::path const& config_path,
+                               [[maybe_unused]] fs::path const& main_dir_path,
+                               [[maybe_unused]] std::vector<fs::path> const& storage_dir_paths,
+                               db_hints_t const& hints) {
+    config_path_ = config_path;
+    hints_ = hints;
+}
+
+bool memory_hash_t::open(std::string& error) {
+    if (shards_)
+        return true;
+
+    if (!load_config(config_)) {
+        error = "Failed to load config";
+        return false;
+    }
+
+    shards_count_ = std::bit_ceil(std::max(config_.shards_count, size_t(1)));
+    shards_ = std::make_unique<shard_t[]>(shards_count_);
+
+    // Size the tables for the whole dataset upfront, so the initial load doesn't rehash
+    size_t shard_records_count = hints_.records_count / shards_count_ + 1;
+    size_t capacity = std::bit_ceil(size_t(shard_records_count / config_.max_load_factor) + 1);
+    for (size_t idx = 0; idx != shards_count_; ++idx)
+        rehash(shards_[idx], capacity);
+    return true;
+}
+
+void memory_hash_t::close() {
+    // Nothing to flush, the data is kept for the next workload
+}
+
+std::string memory_hash_t::info() { return fmt::format("in-memory, {} shards", shards_count_); }
+
+bool memory_hash_t::load_config(config_t& config) {
+    if (!fs::exists(config_path_))
+        return true;
+
+    std::ifstream i_config(config_path_);
+    nlohmann::json j_config;
+    i_config >> j_config;
+
+    config.shards_count = j_config.value<size_t>("shards", size_t(64));
+    config.max_load_factor = std::clamp(j_config.value<float>("max_load_factor", 0.5f), 0.1f, 0.9f);
+    return true;
+}
+
+inline uint64_t memory_hash_t::hash(key_t key) {
+    // The finalizer of SplitMix64, as keys are often sequential
+    uint64_t x = uint64_t(key);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+memory_hash_t::slot_t* memory_hash_t::find(shard_t& shard, key_t key, uint64_t hash) {
+    size_t mask = shard.slots.size() - 1;
+    for (size_t idx = hash & mask;; idx = (idx + 1) & mask) {
+        slot_t& slot = shard.slots[idx];
+        if (slot.state == slot_state_t::empty_k)
+            return nullptr;
+        if (slot.state == slot_state_t::full_k && slot.key == key)
+            return &slot;
+    }
+}
+
+memory_hash_t::slot_t& memory_hash_t::find_or_insert(shard_t& shard, key_t key, uint64_t hash) {
+    if (slot_t* slot = find(shard, key, hash))
+        return *slot;
+
+    if (shard.used_count + 1 > shard.slots.size() * config_.max_load_factor)
+        rehash(shard, std::bit_ceil(size_t((shard.full_count + 1) * 2 / config_.max_load_factor)));
+
+    size_t mask = shard.slots.size() - 1;
+    size_t idx = hash & mask;
+    while (shard.slots[idx].state == slot_state_t::full_k)
+        idx = (idx + 1) & mask;
+
+    slot_t& slot = shard.slots[idx];
+    shard.used_count += slot.state == slot_state_t::empty_k;
+    ++shard.full_count;
+    slot.state = slot_state_t::full_k;
+    slot.key = key;
+    return slot;
+}
+
+void memory_hash_t::rehash(shard_t& shard, size_t capacity) {
+    std::vector<slot_t> slots(std::max(capacity, size_t(16)));
+    size_t mask = slots.size() - 1;
+    for (auto& old_slot : shard.slots) {
+        if (old_slot.state != slot_state_t::full_k)
+            continue;
+        size_t idx = hash(old_slot.key) & mask;
+        while (slots[idx].state == slot_state_t::full_k)
+            idx = (idx + 1) & mask;
+        slots[idx] = std::move(old_slot);
+    }
+    shard.slots = std::move(slots);
+    shard.used_count = shard.full_count;
+}
+
+bool memory_hash_t::copy_value(key_t key, std::byte* target) const {
+    uint64_t key_hash = hash(key);
+    shard_t& shard = this->shard(key_hash);
+    std::shared_lock lock(shard.mutex);
+    slot_t const* slot = find(shard, key, key_hash);
+    if (!slot)
+        return false;
+    memcpy(target, slot->value.data(), slot->value.size());
+    return true;
+}
+
+void memory_hash_t::upsert_value(key_t key, value_spanc_t value) {
+    uint64_t key_hash = hash(key);
+    shard_t& shard = this->shard(key_hash);
+    std::unique_lock lock(shard.mutex);
+    slot_t& slot = find_or_insert(shard, key, key_hash);
+    slot.value.assign(reinterpret_cast<char const*>(value.data()), value.size());
+}
+
+operation_result_t memory_hash_t::upsert(key_t key, value_spanc_t value) {
+    upsert_value(key, value);
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::update(key_t key, value_spanc_t value) {
+    uint64_t key_hash = hash(key);
+    shard_t& shard = this->shard(key_hash);
+    std::unique_lock lock(shard.mutex);
+    slot_t* slot = find(shard, key, key_hash);
+    if (!slot)
+        return {0, operation_status_t::not_found_k};
+
+    slot->value.assign(reinterpret_cast<char const*>(value.data()), value.size());
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::remove(key_t key) {
+    uint64_t key_hash = hash(key);
+    shard_t& shard = this->shard(key_hash);
+    std::unique_lock lock(shard.mutex);
+    slot_t* slot = find(shard, key, key_hash);
+    if (!slot)
+        return {0, operation_status_t::not_found_k};
+
+    slot->state = slot_state_t::removed_k;
+    std::string().swap(slot->value);
+    --shard.full_count;
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::read(key_t key, value_span_t value) const {
+    if (!copy_value(key, value.data()))
+        return {0, operation_status_t::not_found_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::batch_upsert(keys_spanc_t keys,
+                                               values_spanc_t values,
+                                               value_lengths_spanc_t sizes) {
+    size_t offset = 0;
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        upsert_value(keys[idx], values.subspan(offset, sizes[idx]));
+        offset += sizes[idx];
+    }
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key : keys) {
+        uint64_t key_hash = hash(key);
+        shard_t& shard = this->shard(key_hash);
+        std::shared_lock lock(shard.mutex);
+        slot_t const* slot = find(shard, key, key_hash);
+        if (!slot)
+            continue;
+        memcpy(values.data() + offset, slot->value.data(), slot->value.size());
+        offset += slot->value.size();
+        ++found_cnt;
+    }
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t memory_hash_t::range_select(key_t key, size_t length, values_span_t values) const {
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (size_t idx = 0; idx != length; ++idx) {
+        uint64_t key_hash = hash(key + idx);
+        shard_t& shard = this->shard(key_hash);
+        std::shared_lock lock(shard.mutex);
+        slot_t const* slot = find(shard, key + idx, key_hash);
+        if (!slot)
+            continue;
+        memcpy(values.data() + offset, slot->value.data(), slot->value.size());
+        offset += slot->value.size();
+        ++found_cnt;
+    }
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t memory_hash_t::scan(key_t /* key */, size_t length, value_span_t single_value) const {
+    size_t i = 0;
+    for (size_t shard_idx = 0; shard_idx != shards_count_ && i != length; ++shard_idx) {
+        shard_t& shard = shards_[shard_idx];
+        std::shared_lock lock(shard.mutex);
+        for (auto it = shard.slots.begin(); it != shard.slots.end() && i != length; ++it) {
+            if (it->state != slot_state_t::full_k)
+                continue;
+            memcpy(single_value.data(), it->value.data(), it->value.size());
+            ++i;
+        }
+    }
+    return {i, operation_status_t::ok_k};
+}
+
+void memory_hash_t::flush() {
+    // Nothing to flush
+}
+
+size_t memory_hash_t::size_on_disk() const { return 0; }
+
+std::unique_ptr<transaction_t> memory_hash_t::create_transaction() { return {}; }
+
+} // namespace ucsb::memory
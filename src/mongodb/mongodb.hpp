@@ -1,13 +1,21 @@
 #pragma once
 
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
 #include <bsoncxx/types.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/instance.hpp>
 #include <mongocxx/pool.hpp>
+#include <mongocxx/write_concern.hpp>
 
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/per_thread.hpp"
+#include "src/core/server_process.hpp"
 
 namespace ucsb::mongo {
 
@@ -33,19 +41,15 @@ using bsoncxx::builder::basic::make_document;
 /**
  * @brief MongoDB wrapper for the UCSB benchmark.
  * https://github.com/mongodb/mongo-cxx-driver
+ *
+ * The `.cfg` file configures the client, while the `mongod` server
+ * is started with the `.cfg.mongod` file next to it.
  */
 
 /*
  * @brief Preallocated buffers used for batch operations.
  * Globals and especially `thread_local`s are a bad practice.
  */
-
-struct oid_hash_t {
-    size_t operator()(const bsoncxx::oid& oid) const {
-        return std::hash<std::string_view> {}({oid.bytes(), oid.size()});
-    }
-};
-thread_local std::unordered_map<bsoncxx::oid, size_t, oid_hash_t> batch_keys_map;
 thread_local bsoncxx::builder::basic::array batch_keys_array;
 
 class mongodb_t : public ucsb::db_t {
@@ -77,17 +81,41 @@ class mongodb_t : public ucsb::db_t {
     void flush() override;
 
     size_t size_on_disk() const override;
+    db_counters_t counters() override;
 
     std::unique_ptr<transaction_t> create_transaction() override;
 
   private:
+    /**
+     * @brief Every thread holds on to a client of the pool for the whole run,
+     * instead of acquiring one and resolving the collection on every operation.
+     */
+    struct client_t {
+        mongocxx::pool::entry client;
+        mongocxx::collection collection;
+    };
+
+    void get_options(fs::path const& path);
+    mongocxx::collection& collection() const;
+    mongocxx::options::find find_options() const;
+
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
 
     mongocxx::instance inst_;
+    server_process_t server_;
     std::unique_ptr<mongocxx::pool> pool_;
+    mutable per_thread_t<client_t> clients_;
     std::string coll_name;
+
+    std::string uri_ = "mongodb://127.0.0.1:27017/?minPoolSize=1&maxPoolSize=64";
+    std::string db_name_ = "mongodb";
+    mongocxx::write_concern write_concern_;
+    bool ordered_bulk_ = false;
+    int32_t batch_size_ = 1000;
+    std::string server_cpus_;
+    std::chrono::milliseconds startup_timeout_ = std::chrono::seconds(30);
 };
 
 static bsoncxx::oid make_oid(key_t key) {
@@ -105,12 +133,51 @@ static bsoncxx::types::b_binary make_binary(auto value, size_t size) {
     return bin_val;
 }
 
-static void exec_cmd(const char* cmd) {
-    using namespace std::chrono_literals;
-    FILE* pipe = popen(cmd, "r");
-    if (!pipe)
-        throw std::runtime_error("popen() failed!");
-    std::this_thread::sleep_for(2s);
+void mongodb_t::get_options(fs::path const& path) {
+    std::ifstream cfg_file(path);
+    nlohmann::json j_config;
+    cfg_file >> j_config;
+
+    uri_ = j_config.value("uri", uri_);
+    db_name_ = j_config.value("database", db_name_);
+    ordered_bulk_ = j_config.value("ordered_bulk", ordered_bulk_);
+    batch_size_ = j_config.value("batch_size", batch_size_);
+
+    // `w` is either a number of nodes, where zero means unacknowledged writes, or "majority"
+    nlohmann::json j_write_concern = j_config.value("write_concern", nlohmann::json::object());
+    nlohmann::json j_nodes = j_write_concern.value("w", nlohmann::json(1));
+    write_concern_ = {};
+    if (j_nodes.is_string() && j_nodes.get<std::string>() == "majority")
+        write_concern_.acknowledge_level(mongocxx::write_concern::level::k_majority);
+    else if (j_nodes.get<int32_t>() == 0)
+        write_concern_.acknowledge_level(mongocxx::write_concern::level::k_unacknowledged);
+    else
+        write_concern_.nodes(j_nodes.get<int32_t>());
+    write_concern_.journal(j_write_concern.value("journal", false));
+    auto timeout_ms = j_write_concern.value<int64_t>("timeout_ms", 0);
+    if (timeout_ms)
+        write_concern_.timeout(std::chrono::milliseconds(timeout_ms));
+
+    server_cpus_ = j_config.value<std::string>("server_cpus", "");
+    startup_timeout_ = std::chrono::milliseconds(j_config.value<size_t>("startup_timeout_ms", size_t(30000)));
+}
+
+mongocxx::collection& mongodb_t::collection() const {
+    client_t& client = clients_.local();
+    if (!client.client) {
+        client.client = pool_->acquire();
+        client.collection = (*client.client)[db_name_][coll_name];
+        client.collection.write_concern(write_concern_);
+    }
+    return client.collection;
+}
+
+// Only the values are fetched, keys never leave the server
+mongocxx::options::find mongodb_t::find_options() const {
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("_id", 0), kvp("data", 1)));
+    opts.batch_size(batch_size_);
+    return opts;
 }
 
 void mongodb_t::set_config(fs::path const& config_path,
@@ -130,63 +197,68 @@ bool mongodb_t::open(std::string& error) {
         return false;
     }
 
-    std::string start_cmd = "mongod --config ";
-    start_cmd += config_path_;
-    exec_cmd(start_cmd.c_str());
-    pool_ = std::make_unique<mongocxx::pool>(mongocxx::uri {"mongodb://127.0.0.1:27017/?minPoolSize=1&maxPoolSize=64"});
+    get_options(config_path_);
+    if (!server_.start({"mongod", "--config", config_path_.string() + ".mongod"}, server_cpus_, error))
+        return false;
+
+    pool_ = std::make_unique<mongocxx::pool>(mongocxx::uri {uri_});
+    // Server selection blocks itself, until the server is up or its own timeout expires
+    auto probe = [&] {
+        auto client = pool_->acquire();
+        (*client)["admin"].run_command(make_document(kvp("ping", 1)));
+        return true;
+    };
+    if (!server_.wait_ready(probe, startup_timeout_, error)) {
+        pool_.reset();
+        return false;
+    }
     return true;
 }
 
 void mongodb_t::close() {
     batch_keys_array.clear();
-    batch_keys_map.clear();
-    std::string stop_cmd = "sudo mongod -f ";
-    stop_cmd += config_path_;
-    stop_cmd += " --shutdown";
-    exec_cmd(stop_cmd.c_str());
+    // Clients must be returned, before the pool is gone
+    clients_.clear();
+    pool_.reset();
+    server_.stop();
 }
 
+// Unacknowledged writes return no result at all
 operation_result_t mongodb_t::upsert(key_t key, value_spanc_t value) {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
     auto bin_val = make_binary(value.data(), value.size());
     mongocxx::options::update opts;
     opts.upsert(true);
-    if (coll.update_one(make_document(kvp("_id", make_oid(key))),
-                        make_document(kvp("$set", make_document(kvp("data", bin_val)))),
-                        opts)
-            ->modified_count())
+    auto result = collection().update_one(make_document(kvp("_id", make_oid(key))),
+                                          make_document(kvp("$set", make_document(kvp("data", bin_val)))),
+                                          opts);
+    if (!result || result->matched_count() || result->upserted_id())
         return {1, operation_status_t::ok_k};
     return {0, operation_status_t::error_k};
 }
 
 operation_result_t mongodb_t::update(key_t key, value_spanc_t value) {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
     // TODO: Do we need upsert here?
     mongocxx::options::update opts;
     opts.upsert(true);
     auto bin_val = make_binary(value.data(), value.size());
-    if (coll.update_one(make_document(kvp("_id", make_oid(key))),
-                        make_document(kvp("$set", make_document(kvp("data", bin_val)))),
-                        opts)
-            ->modified_count())
+    auto result = collection().update_one(make_document(kvp("_id", make_oid(key))),
+                                          make_document(kvp("$set", make_document(kvp("data", bin_val)))),
+                                          opts);
+    if (!result || result->matched_count() || result->upserted_id())
         return {1, operation_status_t::ok_k};
     return {0, operation_status_t::error_k};
 };
 
 operation_result_t mongodb_t::remove(key_t key) {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    if (coll.delete_one(make_document(kvp("_id", make_oid(key))))->deleted_count())
+    auto result = collection().delete_one(make_document(kvp("_id", make_oid(key))));
+    if (!result || result->deleted_count())
         return {1, operation_status_t::ok_k};
     return {0, operation_status_t::not_found_k};
 };
 
 operation_result_t mongodb_t::read(key_t key, value_span_t value) const {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    bsoncxx::stdx::optional<bsoncxx::document::value> doc = coll.find_one(make_document(kvp("_id", make_oid(key))));
+    bsoncxx::stdx::optional<bsoncxx::document::value> doc =
+        collection().find_one(make_document(kvp("_id", make_oid(key))), find_options());
     if (!doc)
         return {0, operation_status_t::not_found_k};
     auto data = (*doc).view()["data"].get_binary();
@@ -195,9 +267,9 @@ operation_result_t mongodb_t::read(key_t key, value_span_t value) const {
 }
 
 operation_result_t mongodb_t::batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    auto bulk = mongocxx::bulk_write(coll.create_bulk_write());
+    mongocxx::options::bulk_write bulk_opts;
+    bulk_opts.ordered(ordered_bulk_);
+    auto bulk = collection().create_bulk_write(bulk_opts);
     size_t data_offset = 0;
     for (size_t index = 0; index < keys.size(); index++) {
         auto bin_val = make_binary(values.data() + data_offset, sizes[index]);
@@ -208,48 +280,36 @@ operation_result_t mongodb_t::batch_upsert(keys_spanc_t keys, values_spanc_t val
         bulk.append(upsert_op);
         data_offset += sizes[index];
     }
-    size_t modified_count = bulk.execute()->modified_count();
-    if (modified_count == keys.size())
+    auto result = bulk.execute();
+    if (!result || size_t(result->matched_count() + result->upserted_count()) == keys.size())
         return {keys.size(), operation_status_t::ok_k};
     return {0, operation_status_t::error_k};
 }
 
 operation_result_t mongodb_t::batch_read(keys_spanc_t keys, values_span_t values) const {
-    batch_keys_map.reserve(keys.size());
-
-    for (size_t index = 0; index < keys.size(); index++) {
-        auto oid = make_oid(keys[index]);
-        batch_keys_map.emplace(oid, index);
-        batch_keys_array.append(oid);
-    }
+    for (auto key : keys)
+        batch_keys_array.append(make_oid(key));
 
+    // Documents come in no particular order, so values are packed one after another, as they arrive
     size_t found_cnt = 0;
-
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    auto cursor = coll.find(make_document(kvp("_id", make_document(kvp("$in", batch_keys_array)))));
-
+    size_t exported_bytes = 0;
+    auto cursor = collection().find(make_document(kvp("_id", make_document(kvp("$in", batch_keys_array)))),
+                                    find_options());
     for (auto&& doc : cursor) {
-        found_cnt++;
-        auto key = doc["_id"].get_oid().value;
         auto data = doc["data"].get_binary();
-        auto idx = batch_keys_map[key];
-        memcpy(&values[idx], data.bytes, data.size);
+        memcpy(values.data() + exported_bytes, data.bytes, data.size);
+        exported_bytes += data.size;
+        found_cnt++;
     }
-
     batch_keys_array.clear();
-    batch_keys_map.clear();
-
-    if (found_cnt == keys.size())
-        return {keys.size(), operation_status_t::ok_k};
 
-    return {0, operation_status_t::error_k};
+    return {found_cnt, found_cnt ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 operation_result_t mongodb_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    auto bulk = mongocxx::bulk_write(coll.create_bulk_write());
+    mongocxx::options::bulk_write bulk_opts;
+    bulk_opts.ordered(ordered_bulk_);
+    auto bulk = collection().create_bulk_write(bulk_opts);
     size_t data_offset = 0;
     for (size_t index = 0; index < keys.size(); index++) {
         auto bin_val = make_binary(values.data() + data_offset, sizes[index]);
@@ -259,35 +319,33 @@ operation_result_t mongodb_t::bulk_load(keys_spanc_t keys, values_spanc_t values
         data_offset += sizes[index];
     }
 
-    size_t inserted_count = bulk.execute()->inserted_count();
-    if (inserted_count == keys.size())
+    auto result = bulk.execute();
+    if (!result || size_t(result->inserted_count()) == keys.size())
         return {keys.size(), operation_status_t::ok_k};
     return {0, operation_status_t::error_k};
 }
 
-operation_result_t mongodb_t::range_select(key_t key, size_t length, [[maybe_unused]] values_span_t values) const {
+operation_result_t mongodb_t::range_select(key_t key, size_t length, values_span_t values) const {
     size_t i = 0;
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    mongocxx::options::find opts;
+    size_t exported_bytes = 0;
+    mongocxx::options::find opts = find_options();
     opts.limit(length);
-    auto cursor = coll.find(make_document(kvp("_id", make_document(kvp("$gt", make_oid(key))))), opts);
-
-    if (cursor.begin() == cursor.end())
-        return {0, operation_status_t::error_k};
-
+    opts.batch_size(static_cast<int32_t>(std::min<size_t>(length, batch_size_)));
+    auto cursor = collection().find(make_document(kvp("_id", make_document(kvp("$gt", make_oid(key))))), opts);
     for (auto&& doc : cursor) {
-        (void)doc;
+        auto data = doc["data"].get_binary();
+        memcpy(values.data() + exported_bytes, data.bytes, data.size);
+        exported_bytes += data.size;
         i++;
     }
 
+    if (!i)
+        return {0, operation_status_t::error_k};
     return {i, operation_status_t::ok_k};
 }
 
 operation_result_t mongodb_t::scan([[maybe_unused]] key_t key, size_t length, value_span_t single_value) const {
-    auto client = (*pool_).acquire();
-    auto coll = (*client)["mongodb"][coll_name];
-    auto cursor = coll.find({});
+    auto cursor = collection().find({}, find_options());
     size_t i = 0;
     for (auto doc = cursor.begin(); doc != cursor.end() && i++ < length; doc++) {
         auto data = (*doc)["data"].get_binary();
@@ -302,6 +360,12 @@ void mongodb_t::flush() {}
 
 size_t mongodb_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
 
+db_counters_t mongodb_t::counters() {
+    db_counters_t counters;
+    add_server_counters({server_.stats()}, counters);
+    return counters;
+}
+
 std::unique_ptr<transaction_t> mongodb_t::create_transaction() { return {}; }
 
 } // namespace ucsb::mongo
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+
+namespace ucsb::null {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief An engine, which does nothing, to measure the cost of the benchmark itself.
+ * Every operation succeeds immediately without touching the data,
+ * reporting as many entries as were requested, so the accounting stays the same.
+ */
+class null_t : public ucsb::db_t {
+  public:
+    inline null_t() = default;
+    ~null_t() = default;
+
+    void set_config(fs::path const&, fs::path const&, std::vector<fs::path> const&, db_hints_t const&) override {}
+    bool open(std::string&) override { return true; }
+    void close() override {}
+
+    std::string info() override { return "no-op"; }
+
+    operation_result_t upsert(key_t, value_spanc_t) override { return {1, operation_status_t::ok_k}; }
+    operation_result_t update(key_t, value_spanc_t) override { return {1, operation_status_t::ok_k}; }
+    operation_result_t remove(key_t) override { return {1, operation_status_t::ok_k}; }
+    operation_result_t read(key_t, value_span_t) const override { return {1, operation_status_t::ok_k}; }
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t, value_lengths_spanc_t) override {
+        return {keys.size(), operation_status_t::ok_k};
+    }
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t) const override {
+        return {keys.size(), operation_status_t::ok_k};
+    }
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t, value_lengths_spanc_t) override {
+        return {keys.size(), operation_status_t::ok_k};
+    }
+
+    operation_result_t range_select(key_t, size_t length, values_span_t) const override {
+        return {length, operation_status_t::ok_k};
+    }
+    operation_result_t scan(key_t, size_t length, value_span_t) const override {
+        return {length, operation_status_t::ok_k};
+    }
+
+    operation_result_t read_field(key_t, std::string_view, value_span_t) const override {
+        return {1, operation_status_t::ok_k};
+    }
+    operation_result_t patch_field(key_t, std::string_view, value_spanc_t) override {
+        return {1, operation_status_t::ok_k};
+    }
+    operation_result_t upsert_edge(key_t, key_t) override { return {1, operation_status_t::ok_k}; }
+    operation_result_t read_neighbors(key_t) const override { return {1, operation_status_t::ok_k}; }
+
+    void flush() override {}
+
+    size_t size_on_disk() const override { return 0; }
+
+    std::unique_ptr<transaction_t> create_transaction() override { return std::make_unique<null_t>(); }
+};
+
+} // namespace ucsb::null
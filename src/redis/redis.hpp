@@ -1,14 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
 
+#include <fmt/format.h>
 #include <nlohmann/json.hpp>
 #include <sw/redis++/redis++.h>
 
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/per_thread.hpp"
+#include "src/core/server_process.hpp"
 
 namespace ucsb::redis {
 
@@ -25,22 +35,22 @@ using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
 using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
+using db_counters_t = ucsb::db_counters_t;
 using transaction_t = ucsb::transaction_t;
 
 /**
  * @brief Redis wrapper for the UCSB benchmark.
  * Using redis-plus-plus client, based on hiredis.
  * https://github.com/sewenew/redis-plus-plus
+ *
+ * A single Redis server is bound to one core, so it can be sharded across
+ * `shards` local servers. Every shard gets its own port or socket, and keys
+ * are routed to shards by modulo. Every entry is a separate string key, named
+ * by the binary key itself, so no single key grows with the dataset.
  */
 
 struct redis_t : public ucsb::db_t {
   public:
-    ~redis_t() {
-        std::string stop_cmd = "redis-cli -s ";
-        stop_cmd += connection_options_.path;
-        stop_cmd += " shutdown";
-        exec_cmd(stop_cmd.c_str());
-    }
     void set_config(fs::path const& config_path,
                     fs::path const& main_dir_path,
                     std::vector<fs::path> const& storage_dir_paths,
@@ -66,21 +76,102 @@ struct redis_t : public ucsb::db_t {
     void flush() override;
 
     size_t size_on_disk() const override;
+    db_counters_t counters() override;
 
     std::unique_ptr<transaction_t> create_transaction() override;
 
     void get_options(fs::path const& path);
-    std::string exec_cmd(const char* cmd);
 
   private:
+    /**
+     * @brief With `pipeline_depth` above one, single-key operations are queued into
+     * a per-thread pipeline. It is executed once full and on `flush`, when all the
+     * threads are done. Only then every reply is matched against the operation, which
+     * queued it. Queued operations touch no entries, while the one executing the pipeline
+     * reports the verified successes of the whole batch, so errors and misses are never
+     * counted as processed. Those executed on `flush`, or by the read of a read-modify-write,
+     * whose result is dropped, are only seen in `counters`.
+     * Values of pipelined reads are copied into a scratch buffer, so the reply is
+     * fully consumed, but they never reach the caller.
+     */
+    enum class reply_kind_t {
+        write_k,
+        update_k,
+        remove_k,
+        read_k,
+        index_k,
+    };
+
+    struct pipeline_t {
+        std::vector<std::unique_ptr<sw::redis::Pipeline>> pipes;
+        std::vector<std::vector<reply_kind_t>> replies;
+        std::vector<size_t> queued;
+        std::string read_buffer;
+    };
+
+    /**
+     * @brief Redis keyspace is unordered, so ordered access is emulated with a sorted
+     * set of all the keys, scored by the key itself. It's maintained on every write,
+     * which is timed separately. Scores are doubles, so keys beyond 2^53 lose order.
+     */
+    struct index_stats_t {
+        std::atomic<size_t> writes = 0;
+        std::atomic<size_t> write_ns = 0;
+        std::atomic<size_t> index_ns = 0;
+    };
+
+    struct pipeline_stats_t {
+        std::atomic<size_t> flushes = 0;
+        std::atomic<size_t> operations = 0;
+        std::atomic<size_t> failures = 0;
+        std::atomic<size_t> misses = 0;
+        std::atomic<size_t> exec_ns = 0;
+    };
+
+    template <typename command_at>
+    operation_result_t enqueue(key_t key, command_at&& command) const;
+    size_t exec_pipeline(pipeline_t& pipeline, size_t shard_idx) const;
+    void exec_pipelines();
+
+    inline size_t shard_idx(key_t key) const noexcept { return shards_.size() == 1 ? 0 : key % shards_.size(); }
+    inline sw::redis::Redis& shard(key_t key) const noexcept { return *shards_[shard_idx(key)]; }
+
+    /**
+     * @brief Routes the commands for every key to a pipeline of its shard and executes
+     * those, shard by shard. Replies come grouped by shard, not in the order of keys.
+     */
+    template <typename queue_at, typename reply_at>
+    void sharded_batch(keys_spanc_t keys, queue_at&& queue, reply_at&& on_reply) const;
+    void index_keys(keys_spanc_t keys);
+
+    template <typename write_at, typename index_at>
+    auto write_indexed(write_at&& write, index_at&& index);
+
     fs::path config_path_;
     fs::path main_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
 
-    std::unique_ptr<sw::redis::Redis> redis_;
+    // Servers outlive the clients, as members are destroyed in reverse order
+    std::vector<std::unique_ptr<server_process_t>> servers_;
+    std::vector<std::unique_ptr<sw::redis::Redis>> shards_;
     sw::redis::ConnectionOptions connection_options_;
     sw::redis::ConnectionPoolOptions connection_pool_options_;
+    size_t shards_count_ = 1;
+    std::string server_cpus_;
+    std::chrono::milliseconds startup_timeout_ = std::chrono::seconds(30);
     bool is_opened_ = false;
+
+    std::vector<size_t> shard_commands_;
+    std::chrono::high_resolution_clock::time_point shard_commands_time_;
+
+    bool ordered_index_ = false;
+    size_t range_select_chunk_ = 64;
+    size_t scan_count_ = 1000;
+    index_stats_t index_stats_;
+
+    size_t pipeline_depth_ = 1;
+    mutable per_thread_t<pipeline_t> pipelines_;
+    mutable pipeline_stats_t pipeline_stats_;
 };
 
 inline sw::redis::StringView to_string_view(std::byte const* p, size_t size_bytes) noexcept {
@@ -91,20 +182,16 @@ inline sw::redis::StringView to_string_view(key_t const& k) noexcept {
     return {reinterpret_cast<const char*>(&k), sizeof(key_t)};
 }
 
-std::string redis_t::exec_cmd(const char* cmd) {
-    using namespace std::chrono_literals;
-    std::array<char, 4096> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), pclose);
-    if (!pipe)
-        throw std::runtime_error("popen() failed!");
-
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-        result += buffer.data();
-
-    std::this_thread::sleep_for(2s);
-    return result;
-}
+/*
+ * @brief Preallocated buffers used for batch operations and ordered access.
+ * Globals and especially `thread_local`s are a bad practice.
+ */
+thread_local std::vector<std::pair<sw::redis::StringView, double>> index_members;
+thread_local std::vector<std::string> range_members;
+thread_local std::vector<std::string> scan_keys;
+thread_local std::vector<sw::redis::OptionalString> scan_values;
+thread_local std::vector<size_t> value_offsets;
+thread_local std::vector<key_t> range_keys;
 
 void redis_t::get_options(fs::path const& path) {
     std::ifstream cfg_file(path);
@@ -121,6 +208,38 @@ void redis_t::get_options(fs::path const& path) {
     }
     connection_pool_options_.wait_timeout = std::chrono::milliseconds(j_config["wait_timeout"].get<int>());
     connection_pool_options_.size = j_config["pool_size"].get<int>();
+    shards_count_ = std::max(j_config.value<size_t>("shards", size_t(1)), size_t(1));
+    pipeline_depth_ = std::max(j_config.value<size_t>("pipeline_depth", size_t(1)), size_t(1));
+    ordered_index_ = j_config.value<bool>("ordered_index", false);
+    range_select_chunk_ = std::max(j_config.value<size_t>("range_select_chunk", size_t(64)), size_t(1));
+    scan_count_ = std::max(j_config.value<size_t>("scan_count", size_t(1000)), size_t(1));
+    server_cpus_ = j_config.value<std::string>("server_cpus", "");
+    startup_timeout_ = std::chrono::milliseconds(j_config.value<size_t>("startup_timeout_ms", size_t(30000)));
+}
+
+inline double to_score(key_t key) noexcept { return static_cast<double>(key); }
+
+/**
+ * @brief Matches only the entries, named by 8 binary bytes, skipping the ordered "index".
+ */
+constexpr char const* entries_pattern_k = "????????";
+static_assert(sizeof(key_t) == 8, "Check `entries_pattern_k`");
+
+template <typename write_at, typename index_at>
+auto redis_t::write_indexed(write_at&& write, index_at&& index) {
+    if (!ordered_index_)
+        return write();
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto result = write();
+    auto index_start_time = std::chrono::high_resolution_clock::now();
+    index();
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    index_stats_.writes += 1;
+    index_stats_.write_ns += std::chrono::nanoseconds(index_start_time - start_time).count();
+    index_stats_.index_ns += std::chrono::nanoseconds(end_time - index_start_time).count();
+    return result;
 }
 
 void redis_t::set_config(fs::path const& config_path,
@@ -141,40 +260,234 @@ bool redis_t::open(std::string& error) {
         return false;
     }
 
-    std::string start_cmd("redis-server ");
-    start_cmd += config_path_;
-    start_cmd += ".redis";
-    exec_cmd(start_cmd.c_str());
-
     get_options(config_path_);
-    redis_ = std::make_unique<sw::redis::Redis>(sw::redis::Redis(connection_options_, connection_pool_options_));
+    for (size_t idx = 0; idx != shards_count_; ++idx) {
+        // The server stays in foreground, so it can be managed as a child process
+        std::vector<std::string> args {"redis-server", config_path_.string() + ".redis", "--daemonize", "no"};
+
+        sw::redis::ConnectionOptions options = connection_options_;
+        if (shards_count_ > 1) {
+            options.port += int(idx);
+            fs::path socket_path = options.path;
+            if (!socket_path.empty()) {
+                socket_path.replace_filename(fmt::format("{}_{}.sock", socket_path.stem().string(), idx));
+                options.path = socket_path.string();
+            }
+            args.insert(args.end(),
+                        {"--port",
+                         std::to_string(options.port),
+                         "--pidfile",
+                         fmt::format("redis_{}.pid", idx),
+                         "--logfile",
+                         fmt::format("redis_{}.log", idx),
+                         "--dbfilename",
+                         fmt::format("dump_{}.rdb", idx)});
+            // Relative to the `dir` of the server config, like the files above
+            if (!socket_path.empty())
+                args.insert(args.end(), {"--unixsocket", socket_path.filename().string()});
+        }
+
+        auto server = std::make_unique<server_process_t>();
+        if (!server->start(args, server_cpus_, error))
+            return false;
+        auto shard = std::make_unique<sw::redis::Redis>(options, connection_pool_options_);
+        if (!server->wait_ready([&] { return shard->ping() == "PONG"; }, startup_timeout_, error))
+            return false;
+
+        servers_.push_back(std::move(server));
+        shards_.push_back(std::move(shard));
+    }
+
+    shard_commands_.assign(shards_.size(), 0);
+    shard_commands_time_ = std::chrono::high_resolution_clock::now();
     is_opened_ = true;
     return true;
 }
 
-void redis_t::close() {}
+void redis_t::close() {
+    if (!is_opened_)
+        return;
+    exec_pipelines();
+    pipelines_.clear();
+}
+
+template <typename command_at>
+operation_result_t redis_t::enqueue(key_t key, command_at&& command) const {
+    pipeline_t& pipeline = pipelines_.local();
+    if (pipeline.pipes.empty()) {
+        pipeline.pipes.resize(shards_.size());
+        pipeline.replies.resize(shards_.size());
+        pipeline.queued.resize(shards_.size());
+    }
+
+    size_t idx = shard_idx(key);
+    if (!pipeline.pipes[idx])
+        pipeline.pipes[idx] = std::make_unique<sw::redis::Pipeline>(shards_[idx]->pipeline());
+
+    command(*pipeline.pipes[idx], pipeline.replies[idx]);
+    if (++pipeline.queued[idx] != pipeline_depth_)
+        return {0, operation_status_t::ok_k};
+    return {exec_pipeline(pipeline, idx), operation_status_t::ok_k};
+}
+
+/**
+ * @brief Returns the count of queued operations, which succeeded.
+ */
+size_t redis_t::exec_pipeline(pipeline_t& pipeline, size_t shard_idx) const {
+    size_t& queued = pipeline.queued[shard_idx];
+    if (!queued)
+        return 0;
+
+    std::vector<reply_kind_t>& kinds = pipeline.replies[shard_idx];
+    size_t failures = 0;
+    size_t misses = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    try {
+        auto replies = pipeline.pipes[shard_idx]->exec();
+        for (size_t idx = 0; idx != replies.size() && idx != kinds.size(); ++idx) {
+            redisReply& reply = replies.get(idx);
+            if (reply.type == REDIS_REPLY_ERROR) {
+                failures += kinds[idx] != reply_kind_t::index_k;
+                continue;
+            }
+            switch (kinds[idx]) {
+            case reply_kind_t::update_k: misses += reply.type == REDIS_REPLY_NIL; break;
+            case reply_kind_t::remove_k: misses += reply.type != REDIS_REPLY_INTEGER || !reply.integer; break;
+            case reply_kind_t::read_k:
+                if (reply.type == REDIS_REPLY_STRING)
+                    pipeline.read_buffer.assign(reply.str, reply.len);
+                else
+                    ++misses;
+                break;
+            default: break;
+            }
+        }
+    }
+    catch (sw::redis::Error const&) {
+        // The connection is broken, so is every queued command
+        failures = queued;
+        pipeline.pipes[shard_idx].reset();
+    }
+    auto elapsed_time = std::chrono::high_resolution_clock::now() - start_time;
+
+    pipeline_stats_.flushes += 1;
+    pipeline_stats_.operations += queued;
+    pipeline_stats_.failures += failures;
+    pipeline_stats_.misses += misses;
+    pipeline_stats_.exec_ns += std::chrono::nanoseconds(elapsed_time).count();
+    size_t succeeded = queued - std::min(queued, failures + misses);
+    kinds.clear();
+    queued = 0;
+    return succeeded;
+}
+
+void redis_t::exec_pipelines() {
+    pipelines_.for_each([&](pipeline_t& pipeline) {
+        for (size_t idx = 0; idx != pipeline.pipes.size(); ++idx)
+            exec_pipeline(pipeline, idx);
+    });
+}
+
+template <typename queue_at, typename reply_at>
+void redis_t::sharded_batch(keys_spanc_t keys, queue_at&& queue, reply_at&& on_reply) const {
+    std::vector<std::unique_ptr<sw::redis::Pipeline>> pipes(shards_.size());
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        size_t shard = shard_idx(keys[idx]);
+        if (!pipes[shard])
+            pipes[shard] = std::make_unique<sw::redis::Pipeline>(shards_[shard]->pipeline(false));
+        queue(*pipes[shard], idx);
+    }
+
+    for (auto& pipe : pipes) {
+        if (!pipe)
+            continue;
+        auto replies = pipe->exec();
+        for (size_t idx = 0; idx != replies.size(); ++idx)
+            on_reply(replies.get(idx));
+    }
+}
+
+void redis_t::index_keys(keys_spanc_t keys) {
+    if (shards_.size() == 1) {
+        index_members.clear();
+        for (auto const& key : keys)
+            index_members.emplace_back(to_string_view(key), to_score(key));
+        shards_.front()->zadd("index", index_members.begin(), index_members.end());
+        return;
+    }
+
+    sharded_batch(
+        keys,
+        [&](sw::redis::Pipeline& pipe, size_t idx) {
+            pipe.zadd("index", to_string_view(keys[idx]), to_score(keys[idx]));
+        },
+        [](redisReply&) {});
+}
 
 operation_result_t redis_t::upsert(key_t key, value_spanc_t value) {
-    auto status = (*redis_).hset("hash", to_string_view(key), to_string_view(value.data(), value.size()));
+    if (pipeline_depth_ > 1)
+        return enqueue(key, [&](sw::redis::Pipeline& pipe, std::vector<reply_kind_t>& replies) {
+            pipe.set(to_string_view(key), to_string_view(value.data(), value.size()));
+            replies.push_back(reply_kind_t::write_k);
+            if (ordered_index_) {
+                pipe.zadd("index", to_string_view(key), to_score(key));
+                replies.push_back(reply_kind_t::index_k);
+            }
+        });
+
+    auto status = write_indexed(
+        [&] { return shard(key).set(to_string_view(key), to_string_view(value.data(), value.size())); },
+        [&] { shard(key).zadd("index", to_string_view(key), to_score(key)); });
     return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t redis_t::update(key_t key, value_spanc_t value) {
-    auto status = (*redis_).hset("hash", to_string_view(key), to_string_view(value.data(), value.size()));
-    return {status, status ? operation_status_t::ok_k : operation_status_t::not_found_k};
+    // Updated keys are already indexed, and `XX` only sets the existing ones
+    auto const no_ttl = std::chrono::milliseconds(0);
+    if (pipeline_depth_ > 1)
+        return enqueue(key, [&](sw::redis::Pipeline& pipe, std::vector<reply_kind_t>& replies) {
+            pipe.set(to_string_view(key),
+                     to_string_view(value.data(), value.size()),
+                     no_ttl,
+                     sw::redis::UpdateType::EXIST);
+            replies.push_back(reply_kind_t::update_k);
+        });
+
+    bool status = shard(key).set(to_string_view(key),
+                                 to_string_view(value.data(), value.size()),
+                                 no_ttl,
+                                 sw::redis::UpdateType::EXIST);
+    return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 operation_result_t redis_t::remove(key_t key) {
-    size_t count = (*redis_).hdel("hash", to_string_view(key));
+    if (pipeline_depth_ > 1)
+        return enqueue(key, [&](sw::redis::Pipeline& pipe, std::vector<reply_kind_t>& replies) {
+            pipe.del(to_string_view(key));
+            replies.push_back(reply_kind_t::remove_k);
+            if (ordered_index_) {
+                pipe.zrem("index", to_string_view(key));
+                replies.push_back(reply_kind_t::index_k);
+            }
+        });
+
+    size_t count = write_indexed([&] { return size_t(shard(key).del(to_string_view(key))); },
+                                 [&] { shard(key).zrem("index", to_string_view(key)); });
     return {count, count ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 operation_result_t redis_t::read(key_t key, value_span_t value) const {
-    auto val = (*redis_).hget("hash", to_string_view(key));
+    if (pipeline_depth_ > 1)
+        return enqueue(key, [&](sw::redis::Pipeline& pipe, std::vector<reply_kind_t>& replies) {
+            pipe.get(to_string_view(key));
+            replies.push_back(reply_kind_t::read_k);
+        });
+
+    auto val = shard(key).get(to_string_view(key));
     if (!val)
         return {0, operation_status_t::not_found_k};
 
-    memcpy(value.data(), &val, sizeof(val));
+    memcpy(value.data(), val->data(), val->size());
     return {1, operation_status_t::ok_k};
 }
 
@@ -205,10 +518,29 @@ operation_result_t redis_t::batch_upsert(keys_spanc_t keys, values_spanc_t value
         }
     };
 
-    (*redis_).hmset(
-        "hash",
-        kv_iterator_t(keys.data(), values.data(), sizes.data()),
-        kv_iterator_t(keys.data() + keys.size(), values.data() + values.size(), sizes.data() + sizes.size()));
+    write_indexed(
+        [&] {
+            if (shards_.size() == 1) {
+                shards_.front()->mset(kv_iterator_t(keys.data(), values.data(), sizes.data()),
+                                      kv_iterator_t(keys.data() + keys.size(),
+                                                    values.data() + values.size(),
+                                                    sizes.data() + sizes.size()));
+                return true;
+            }
+
+            value_offsets.clear();
+            for (size_t idx = 0, offset = 0; idx != keys.size(); offset += sizes[idx], ++idx)
+                value_offsets.push_back(offset);
+            sharded_batch(
+                keys,
+                [&](sw::redis::Pipeline& pipe, size_t idx) {
+                    pipe.set(to_string_view(keys[idx]),
+                             to_string_view(values.data() + value_offsets[idx], sizes[idx]));
+                },
+                [](redisReply&) {});
+            return true;
+        },
+        [&] { index_keys(keys); });
     return {keys.size(), operation_status_t::ok_k};
 }
 
@@ -237,52 +569,218 @@ operation_result_t redis_t::batch_read(keys_spanc_t keys, values_span_t values)
         iterator push_back(value_type value) noexcept {
             if (!value)
                 return values.data() + offset;
-            memcpy(values.data() + offset, &value, sizeof(value));
-            offset += sizeof(value);
+            memcpy(values.data() + offset, value->data(), value->size());
+            offset += value->size();
             count++;
             return values.data() + offset;
         }
     };
 
     value_getter_t getter(values);
-    (*redis_).hmget("hash",
-                    key_iterator_t(keys.data()),
-                    key_iterator_t(keys.data() + keys.size()),
-                    std::back_inserter(getter));
+    if (shards_.size() == 1)
+        shards_.front()->mget(key_iterator_t(keys.data()),
+                              key_iterator_t(keys.data() + keys.size()),
+                              std::back_inserter(getter));
+    else
+        sharded_batch(
+            keys,
+            [&](sw::redis::Pipeline& pipe, size_t idx) { pipe.get(to_string_view(keys[idx])); },
+            [&](redisReply& reply) {
+                if (reply.type == REDIS_REPLY_STRING)
+                    getter.push_back(std::string(reply.str, reply.len));
+            });
     return {getter.count, getter.count ? operation_status_t::ok_k : operation_status_t::error_k};
 }
 
 operation_result_t redis_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
-    auto data_offset = 0;
-    auto pipe = (*redis_).pipeline(false);
-    for (size_t i = 0; i != keys.size(); ++i) {
-        pipe.hset("hash", to_string_view(keys[i]), to_string_view(values.data() + data_offset, sizes[i]));
-        data_offset += sizes[i];
-    }
-
-    auto pipe_replies = pipe.exec();
-
-    size_t count = 0;
-    for (size_t i = 0; i != keys.size(); ++i)
-        count += pipe_replies.get<bool>(i);
+    size_t count = write_indexed(
+        [&] {
+            value_offsets.clear();
+            for (size_t idx = 0, offset = 0; idx != keys.size(); offset += sizes[idx], ++idx)
+                value_offsets.push_back(offset);
+
+            size_t count = 0;
+            sharded_batch(
+                keys,
+                [&](sw::redis::Pipeline& pipe, size_t idx) {
+                    pipe.set(to_string_view(keys[idx]),
+                             to_string_view(values.data() + value_offsets[idx], sizes[idx]));
+                },
+                [&](redisReply& reply) { count += reply.type == REDIS_REPLY_STATUS; });
+            return count;
+        },
+        [&] { index_keys(keys); });
 
     return {count, operation_status_t::ok_k};
 }
 
-operation_result_t redis_t::range_select(key_t /* key */, size_t /* length */, values_span_t /* values */) const {
-    return {0, operation_status_t::not_implemented_k};
+operation_result_t redis_t::range_select(key_t key, size_t length, values_span_t values) const {
+    if (!ordered_index_)
+        return {0, operation_status_t::not_implemented_k};
+
+    range_members.clear();
+    auto interval = sw::redis::LeftBoundedInterval<double>(to_score(key), sw::redis::BoundType::RIGHT_OPEN);
+    auto limit = sw::redis::LimitOptions {0, static_cast<long long>(length)};
+    for (auto const& shard : shards_)
+        shard->zrangebyscore("index", interval, limit, std::back_inserter(range_members));
+    if (range_members.empty())
+        return {0, operation_status_t::not_found_k};
+
+    size_t found_cnt = 0;
+    size_t exported_bytes = 0;
+    auto export_reply = [&](redisReply& reply) {
+        for (size_t element_idx = 0; element_idx != reply.elements; ++element_idx) {
+            redisReply const& element = *reply.element[element_idx];
+            if (element.type != REDIS_REPLY_STRING)
+                continue;
+            memcpy(values.data() + exported_bytes, element.str, element.len);
+            exported_bytes += element.len;
+            ++found_cnt;
+        }
+    };
+
+    if (shards_.size() == 1) {
+        // A single round trip for all the chunks
+        auto pipe = shards_.front()->pipeline(false);
+        for (size_t offset = 0; offset < range_members.size(); offset += range_select_chunk_) {
+            size_t chunk = std::min(range_select_chunk_, range_members.size() - offset);
+            pipe.mget(range_members.begin() + offset, range_members.begin() + offset + chunk);
+        }
+        auto replies = pipe.exec();
+        for (size_t idx = 0; idx != replies.size(); ++idx)
+            export_reply(replies.get(idx));
+        return {found_cnt, found_cnt ? operation_status_t::ok_k : operation_status_t::not_found_k};
+    }
+
+    // Every shard returned its own first `length` keys, so merge those and keep the global first ones
+    range_keys.clear();
+    for (auto const& member : range_members) {
+        key_t range_key = 0;
+        memcpy(&range_key, member.data(), std::min(member.size(), sizeof(key_t)));
+        range_keys.push_back(range_key);
+    }
+    std::sort(range_keys.begin(), range_keys.end());
+    range_keys.resize(std::min(range_keys.size(), length));
+
+    sharded_batch(
+        range_keys,
+        [&](sw::redis::Pipeline& pipe, size_t idx) { pipe.get(to_string_view(range_keys[idx])); },
+        [&](redisReply& reply) {
+            if (reply.type != REDIS_REPLY_STRING)
+                return;
+            memcpy(values.data() + exported_bytes, reply.str, reply.len);
+            exported_bytes += reply.len;
+            ++found_cnt;
+        });
+    return {found_cnt, found_cnt ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
-operation_result_t redis_t::scan(key_t /* key */, size_t /* length */, value_span_t /* single_value */) const {
-    return {0, operation_status_t::not_implemented_k};
+operation_result_t redis_t::scan(key_t /* key */, size_t length, value_span_t single_value) const {
+    // The keyspace has no order, so the scan starts from the beginning, whatever the key is
+    size_t scanned_cnt = 0;
+    for (size_t shard_idx = 0; shard_idx != shards_.size() && scanned_cnt != length; ++shard_idx) {
+        auto& shard = *shards_[shard_idx];
+        long long cursor = 0;
+        do {
+            scan_keys.clear();
+            cursor = shard.scan(cursor,
+                                entries_pattern_k,
+                                static_cast<long long>(scan_count_),
+                                std::back_inserter(scan_keys));
+            scan_keys.resize(std::min(scan_keys.size(), length - scanned_cnt));
+            if (scan_keys.empty())
+                continue;
+
+            // Keys come without values, so those are fetched with a single round trip per page
+            scan_values.clear();
+            shard.mget(scan_keys.begin(), scan_keys.end(), std::back_inserter(scan_values));
+            for (auto const& value : scan_values) {
+                if (!value)
+                    continue;
+                memcpy(single_value.data(), value->data(), value->size());
+                ++scanned_cnt;
+            }
+        } while (cursor != 0 && scanned_cnt != length);
+    }
+
+    return {scanned_cnt, scanned_cnt ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
 std::string redis_t::info() { return {}; }
 
-void redis_t::flush() {}
+void redis_t::flush() { exec_pipelines(); }
 
 size_t redis_t::size_on_disk() const { return 0; }
 
+db_counters_t redis_t::counters() {
+    db_counters_t counters;
+    std::vector<server_process_t::stats_t> servers_stats;
+    for (auto& server : servers_)
+        servers_stats.push_back(server->stats());
+    add_server_counters(servers_stats, counters);
+
+    size_t index_writes = index_stats_.writes.exchange(0);
+    size_t write_ns = index_stats_.write_ns.exchange(0);
+    size_t index_ns = index_stats_.index_ns.exchange(0);
+    if (index_writes) {
+        counters["index_latency,us"] = index_ns / 1e3 / index_writes;
+        counters["index_overhead,%"] = write_ns ? index_ns * 100.0 / write_ns : 0.0;
+    }
+    if (ordered_index_) {
+        try {
+            size_t index_memory = 0;
+            for (auto const& shard : shards_) {
+                auto index_size = shard->command<sw::redis::OptionalLongLong>("MEMORY", "USAGE", "index");
+                index_memory += index_size ? size_t(*index_size) : 0;
+            }
+            counters["index_memory,bytes"] = double(index_memory);
+        }
+        catch (sw::redis::Error const&) {
+        }
+    }
+
+    // Throughput of every server, to spot imbalanced shards
+    if (shards_.size() > 1) {
+        auto now = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(now - shard_commands_time_).count();
+        shard_commands_time_ = now;
+        for (size_t idx = 0; idx != shards_.size(); ++idx) {
+            try {
+                std::string stats = shards_[idx]->info("stats");
+                std::string_view const field = "total_commands_processed:";
+                size_t pos = stats.find(field);
+                if (pos == std::string::npos)
+                    continue;
+                size_t commands = std::strtoull(stats.c_str() + pos + field.size(), nullptr, 10);
+                if (seconds > 0)
+                    counters[fmt::format("shard[{}]_commands/s", idx)] = (commands - shard_commands_[idx]) / seconds;
+                shard_commands_[idx] = commands;
+            }
+            catch (sw::redis::Error const&) {
+            }
+        }
+    }
+
+    size_t flushes = pipeline_stats_.flushes.exchange(0);
+    size_t operations = pipeline_stats_.operations.exchange(0);
+    size_t failures = pipeline_stats_.failures.exchange(0);
+    size_t misses = pipeline_stats_.misses.exchange(0);
+    size_t exec_ns = pipeline_stats_.exec_ns.exchange(0);
+    if (!flushes)
+        return counters;
+
+    // Every operation of a batch waits for the whole round trip
+    counters["pipeline_depth"] = double(operations) / flushes;
+    counters["pipeline_latency,us"] = exec_ns / 1e3 / flushes;
+    counters["pipeline_operation_latency,us"] = exec_ns / 1e3 / operations;
+    // Outcomes of all pipelined operations, including those executed on `flush`
+    counters["pipeline_acknowledged"] = double(operations);
+    counters["pipeline_succeeded"] = double(operations - std::min(operations, failures + misses));
+    counters["pipeline_misses"] = double(misses);
+    counters["pipeline_fails,%"] = (failures + misses) * 100.0 / operations;
+    return counters;
+}
+
 std::unique_ptr<transaction_t> redis_t::create_transaction() { return {}; }
 
 } // namespace ucsb::redis
@@ -1,11 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <iostream>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <string>
+#include <thread>
 #include <vector>
+#include <limits>
+#include <unordered_map>
 
 #include <fmt/format.h>
 #include <rocksdb/status.h>
@@ -17,14 +23,29 @@
 #include <rocksdb/options.h>
 #include <rocksdb/comparator.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+#include <rocksdb/statistics.h>
 
 #include "src/core/types.hpp"
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
+#include "src/core/per_thread.hpp"
+
+/**
+ * @brief Speedb compiles the same wrapper once more, against its own headers,
+ * so it has to live in a namespace of its own. See `src/speedb/speedb.cxx`.
+ */
+#if !defined(UCSB_ROCKSDB_WRAPPER_NAMESPACE)
+#define UCSB_ROCKSDB_WRAPPER_NAMESPACE facebook
+#endif
 
 #include "rocksdb_transaction.hpp"
+#include "rocksdb_optimistic_transaction.hpp"
 
-namespace ucsb::facebook {
+namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE {
 
 namespace fs = ucsb::fs;
 
@@ -38,11 +59,13 @@ using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
 using operation_status_t = ucsb::operation_status_t;
 using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
+using db_counters_t = ucsb::db_counters_t;
 using transaction_t = ucsb::transaction_t;
 
 enum class db_mode_t {
     regular_k,
     transactional_k,
+    optimistic_k,
 };
 
 /*
@@ -64,7 +87,7 @@ thread_local std::vector<rocksdb::Status> statuses;
 class rocksdb_t : public ucsb::db_t {
   public:
     inline rocksdb_t(db_mode_t mode = db_mode_t::regular_k)
-        : db_(nullptr), transaction_db_(nullptr), mode_(mode), full_compaction_(false) {}
+        : db_(nullptr), transaction_db_(nullptr), optimistic_db_(nullptr), mode_(mode), full_compaction_(false) {}
     ~rocksdb_t() { close(); }
 
     void set_config(fs::path const& config_path,
@@ -92,16 +115,143 @@ class rocksdb_t : public ucsb::db_t {
     void flush() override;
 
     size_t size_on_disk() const override;
+    db_counters_t counters() override;
 
     std::unique_ptr<transaction_t> create_transaction() override;
 
   private:
+    /**
+     * @brief Overrides on top of the table options loaded from the `.cfg` file.
+     * Empty strings keep whatever the options file specified. A zero cache size
+     * means ten times `target_file_size_base`, so it grows with the dataset size.
+     */
+    struct table_config_t {
+        std::string factory;
+        std::string cache;
+        size_t cache_size = 0;
+        std::string filter;
+        double filter_bits_per_key = 10;
+        bool partitioned_index_filters = false;
+    };
+
+    /**
+     * @brief Bulk load either ingests the SSTs of every batch right away, or, in
+     * the deferred mode, keeps a writer per thread, rolls files over at the target
+     * size, and ingests the whole set at once on `flush`. Threads load disjoint
+     * key ranges, so the files don't overlap and can go straight to the last level.
+     */
+    struct bulk_load_config_t {
+        bool deferred_ingestion = false;
+        size_t target_file_size = 256ul * 1024 * 1024;
+        bool ingest_behind = false;
+        bool compact = true;
+    };
+
+    /**
+     * @brief Integrated BlobDB, which separates large values from the LSM tree.
+     * https://github.com/facebook/rocksdb/wiki/BlobDB
+     */
+    struct blob_config_t {
+        bool enable = false;
+        size_t min_blob_size = 4096;
+        size_t blob_file_size = 256ul * 1024 * 1024;
+        std::string compression = "none";
+        bool garbage_collection = true;
+        double garbage_collection_age_cutoff = 0.25;
+        double garbage_collection_force_threshold = 1.0;
+    };
+
+    /**
+     * @brief Reader processes can't open the DB of the primary, so they open it
+     * as a secondary instance, which tails its MANIFEST and WAL, or as a static
+     * read-only snapshot. Secondaries catch up on a fixed interval in background.
+     * Their own directories are siblings of the main one, so they don't count into its size.
+     * https://github.com/facebook/rocksdb/wiki/Read-only-and-Secondary-instances
+     */
+    struct replica_config_t {
+        std::string mode = "secondary";
+        size_t catch_up_interval_ms = 100;
+    };
+
+    /**
+     * @brief Sequence numbers, a catch-up advances a secondary by, are the writes
+     * of the primary it has been missing, so those measure the lag.
+     */
+    struct catch_up_stats_t {
+        std::atomic<size_t> count = 0;
+        std::atomic<size_t> total_ns = 0;
+        std::atomic<size_t> max_ns = 0;
+        std::atomic<size_t> total_lag = 0;
+        std::atomic<size_t> max_lag = 0;
+    };
+
+    /**
+     * @brief Short range selects are dominated by iterator construction, which pins
+     * a SuperVersion and allocates a merging iterator. Pooled iterators are kept
+     * per thread and only `Refresh`-ed to the latest state before the next `Seek`.
+     * The upper bound assumes dense keys, cutting the range at `key + length`.
+     */
+    struct range_select_config_t {
+        bool pooled_iterators = true;
+        bool upper_bound = false;
+        size_t readahead_size = 0;
+    };
+
+    struct pooled_iterator_t {
+        std::unique_ptr<rocksdb::Iterator> iterator;
+        key_t upper_bound_key = 0;
+        rocksdb::Slice upper_bound;
+    };
+
+    struct pending_sst_t {
+        std::unique_ptr<rocksdb::SstFileWriter> writer;
+        std::vector<std::string> files;
+        key_t last_key = 0;
+        size_t entries = 0;
+    };
+
+    struct bulk_load_stats_t {
+        std::atomic<size_t> generate_ns = 0;
+        std::atomic<size_t> ingest_ns = 0;
+        std::atomic<size_t> compact_ns = 0;
+        std::atomic<size_t> files = 0;
+        std::atomic<size_t> failed_entries = 0;
+    };
+
+    /**
+     * @brief I/O profile of `MultiGet` calls, collected via `PerfContext`.
+     * Block read time summed over all reads of a batch, divided by the batch
+     * wall time, gives the effective number of reads in flight.
+     */
+    struct multiget_stats_t {
+        std::atomic<size_t> batches = 0;
+        std::atomic<size_t> block_reads = 0;
+        std::atomic<size_t> block_read_ns = 0;
+        std::atomic<size_t> wall_ns = 0;
+    };
+
     fs::path config_path_;
     fs::path main_dir_path_;
+    fs::path secondary_dir_path_;
     std::vector<fs::path> storage_dir_paths_;
     db_hints_t hints_;
+    table_config_t table_config_;
+    bulk_load_config_t bulk_load_config_;
+    blob_config_t blob_config_;
+    replica_config_t replica_config_;
+    range_select_config_t range_select_config_;
 
     bool load_additional_options();
+    bool apply_table_options(rocksdb::ColumnFamilyOptions& cf_options, std::string& error);
+    bool apply_blob_options(rocksdb::ColumnFamilyOptions& cf_options, std::string& error);
+
+    void catch_up_with_primary();
+    rocksdb::Iterator* pooled_iterator(key_t upper_bound_key) const;
+
+    std::string sst_dir_path() const;
+    operation_result_t bulk_load_deferred(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes);
+    rocksdb::Status finish_pending_sst(pending_sst_t& pending);
+    void ingest_pending_ssts();
 
     class key_comparator_t final : public rocksdb::Comparator {
         int Compare(rocksdb::Slice const& left, rocksdb::Slice const& right) const override {
@@ -120,13 +270,34 @@ class rocksdb_t : public ucsb::db_t {
     rocksdb::Options options_;
     rocksdb::TransactionDBOptions transaction_options_;
     rocksdb::ReadOptions read_options_;
+    rocksdb::ReadOptions multiget_options_;
+    rocksdb::ReadOptions range_select_options_;
     rocksdb::WriteOptions write_options_;
+    bool multiget_io_stats_ = false;
+    mutable multiget_stats_t multiget_stats_;
+
+    mutable per_thread_t<pooled_iterator_t> pooled_iterators_;
+
+    std::mutex pending_ssts_mutex_;
+    std::unordered_map<std::thread::id, pending_sst_t> pending_ssts_;
+    std::atomic<size_t> pending_ssts_count_ = 0;
+    bulk_load_stats_t bulk_load_stats_;
+
+    std::thread catch_up_thread_;
+    std::mutex catch_up_mutex_;
+    std::condition_variable catch_up_condition_;
+    bool catch_up_stop_ = false;
+    catch_up_stats_t catch_up_stats_;
 
     std::vector<rocksdb::ColumnFamilyDescriptor> cf_descs_;
     std::vector<rocksdb::ColumnFamilyHandle*> cf_handles_;
 
+    std::shared_ptr<rocksdb::Cache> block_cache_;
     std::unique_ptr<rocksdb::DB> db_;
     rocksdb::TransactionDB* transaction_db_;
+    rocksdb::OptimisticTransactionDB* optimistic_db_;
+    size_t optimistic_max_retries_ = 0;
+    optimistic_transaction_stats_t optimistic_stats_;
     key_comparator_t key_cmp_;
     db_mode_t mode_;
     std::atomic_bool full_compaction_;
@@ -162,23 +333,57 @@ bool rocksdb_t::open(std::string& error) {
         return false;
     }
 
-    rocksdb::BlockBasedTableOptions table_options;
-    table_options.block_cache = rocksdb::NewLRUCache(options_.target_file_size_base * 10);
-    table_options.cache_index_and_filter_blocks = true;
-    table_options.cache_index_and_filter_blocks_with_high_priority = true;
-    table_options.enable_index_compression = false;
-    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
-    options_.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+    // `LoadOptionsFromFile` only fills the `DBOptions` part of `options_`, the column family
+    // options, including `[TableOptions/*]` sections, are loaded into the descriptors.
+    block_cache_.reset();
+    for (auto& cf_desc : cf_descs_) {
+        if (!apply_table_options(cf_desc.options, error) || !apply_blob_options(cf_desc.options, error))
+            return false;
+    }
+    // Keep the column family part in sync, as `SstFileWriter` in `bulk_load` uses it
+    static_cast<rocksdb::ColumnFamilyOptions&>(options_) = cf_descs_.front().options;
+    if (bulk_load_config_.ingest_behind)
+        options_.allow_ingest_behind = true;
+    if (blob_config_.enable && !options_.statistics)
+        options_.statistics = rocksdb::CreateDBStatistics();
     // options_.comparator = &key_cmp_;
 
     // Overwrite latency-affecting settings, that aren't externally configurable.
     read_options_.verify_checksums = false;
     read_options_.background_purge_on_iterator_cleanup = true;
+    multiget_options_.verify_checksums = false;
+    range_select_options_ = read_options_;
+    range_select_options_.readahead_size = range_select_config_.readahead_size;
     write_options_.disableWAL = true;
 
     rocksdb::DB* db_raw = nullptr;
-    if (mode_ == db_mode_t::regular_k)
+    if (hints_.read_replica && replica_config_.mode == "read_only")
+        status = rocksdb::DB::OpenForReadOnly(options_, main_dir_path_.string(), cf_descs_, &cf_handles_, &db_raw);
+    else if (hints_.read_replica) {
+        // Secondaries must keep all the files open to follow the primary
+        options_.max_open_files = -1;
+        fs::path main_dir_path = main_dir_path_.lexically_normal();
+        if (!main_dir_path.has_filename())
+            main_dir_path = main_dir_path.parent_path();
+        secondary_dir_path_ = main_dir_path.parent_path() /
+                              fmt::format("{}_secondary_{}", main_dir_path.filename().string(), hints_.replica_idx);
+        status = rocksdb::DB::OpenAsSecondary(options_,
+                                              main_dir_path_.string(),
+                                              secondary_dir_path_.string(),
+                                              cf_descs_,
+                                              &cf_handles_,
+                                              &db_raw);
+    }
+    else if (mode_ == db_mode_t::regular_k)
         status = rocksdb::DB::Open(options_, main_dir_path_.string(), cf_descs_, &cf_handles_, &db_raw);
+    else if (mode_ == db_mode_t::optimistic_k) {
+        status = rocksdb::OptimisticTransactionDB::Open(options_,
+                                                        main_dir_path_.string(),
+                                                        cf_descs_,
+                                                        &cf_handles_,
+                                                        &optimistic_db_);
+        db_raw = optimistic_db_;
+    }
     else {
         status = rocksdb::TransactionDB::Open(options_,
                                               transaction_options_,
@@ -192,6 +397,11 @@ bool rocksdb_t::open(std::string& error) {
     db_.reset(db_raw);
     full_compaction_.store(false);
 
+    if (status.ok() && hints_.read_replica && replica_config_.mode != "read_only") {
+        catch_up_stop_ = false;
+        catch_up_thread_ = std::thread(&rocksdb_t::catch_up_with_primary, this);
+    }
+
     error = status.ok() ? std::string() : status.ToString();
     return status.ok();
 }
@@ -202,10 +412,34 @@ void rocksdb_t::close() {
     value_slices.clear();
     statuses.clear();
 
+    if (catch_up_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(catch_up_mutex_);
+            catch_up_stop_ = true;
+        }
+        catch_up_condition_.notify_all();
+        catch_up_thread_.join();
+    }
+
+    for (auto& [thread_id, pending] : pending_ssts_) {
+        pending.writer.reset();
+        for (auto const& file_path : pending.files)
+            fs::remove(file_path);
+    }
+    pending_ssts_.clear();
+    pooled_iterators_.clear();
+
     db_.reset(nullptr);
+    block_cache_.reset();
+    if (!secondary_dir_path_.empty()) {
+        std::error_code ec;
+        fs::remove_all(secondary_dir_path_, ec);
+        secondary_dir_path_.clear();
+    }
     cf_descs_.clear();
     cf_handles_.clear();
     transaction_db_ = nullptr;
+    optimistic_db_ = nullptr;
 }
 
 operation_result_t rocksdb_t::upsert(key_t key, value_spanc_t value) {
@@ -271,13 +505,30 @@ operation_result_t rocksdb_t::batch_read(keys_spanc_t keys, values_span_t values
     for (size_t idx = 0; idx != keys.size(); ++idx)
         key_slices[idx] = to_slice(batch_keys[idx] = keys[idx]);
 
-    db_->MultiGet(read_options_,
+    std::chrono::high_resolution_clock::time_point start_time;
+    if (multiget_io_stats_) {
+        rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+        rocksdb::get_perf_context()->Reset();
+        start_time = std::chrono::high_resolution_clock::now();
+    }
+
+    db_->MultiGet(multiget_options_,
                   cf_handles_.front(),
                   key_slices.size(),
                   key_slices.data(),
                   value_slices.data(),
                   statuses.data());
 
+    if (multiget_io_stats_) {
+        auto wall_time = std::chrono::high_resolution_clock::now() - start_time;
+        rocksdb::PerfContext const* perf = rocksdb::get_perf_context();
+        multiget_stats_.batches.fetch_add(1, std::memory_order_relaxed);
+        multiget_stats_.block_reads.fetch_add(perf->block_read_count, std::memory_order_relaxed);
+        multiget_stats_.block_read_ns.fetch_add(perf->block_read_time, std::memory_order_relaxed);
+        multiget_stats_.wall_ns.fetch_add(std::chrono::nanoseconds(wall_time).count(), std::memory_order_relaxed);
+        rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+    }
+
     size_t offset = 0;
     size_t found_cnt = 0;
     for (size_t i = 0; i != statuses.size(); ++i) {
@@ -292,17 +543,18 @@ operation_result_t rocksdb_t::batch_read(keys_spanc_t keys, values_span_t values
 }
 
 operation_result_t rocksdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    if (bulk_load_config_.deferred_ingestion)
+        return bulk_load_deferred(keys, values, sizes);
+
     size_t idx = 0;
     size_t data_offset = 0;
     std::vector<std::string> files;
 
     size_t this_thread_id = std::hash<std::thread::id> {}(std::this_thread::get_id());
     std::string this_thread_id_str = std::to_string(this_thread_id);
+    std::string sst_dir_path = this->sst_dir_path();
 
-    std::string sst_dir_path = main_dir_path_.string();
-    if (!storage_dir_paths_.empty())
-        sst_dir_path = storage_dir_paths_.front().string();
-
+    auto generate_start_time = std::chrono::high_resolution_clock::now();
     while (idx < keys.size()) {
         std::string sst_file_path = fmt::format("{}pending_{}_{}.sst", sst_dir_path, this_thread_id_str, files.size());
 
@@ -332,11 +584,17 @@ operation_result_t rocksdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values
         return {0, operation_status_t::error_k};
     }
 
+    auto ingest_start_time = std::chrono::high_resolution_clock::now();
     rocksdb::IngestExternalFileOptions ingest_options;
     ingest_options.move_files = true;
     rocksdb::Status status = db_->IngestExternalFile(files, ingest_options);
+    auto ingest_end_time = std::chrono::high_resolution_clock::now();
     for (auto const& file_path : files)
         fs::remove(file_path);
+
+    bulk_load_stats_.generate_ns += std::chrono::nanoseconds(ingest_start_time - generate_start_time).count();
+    bulk_load_stats_.ingest_ns += std::chrono::nanoseconds(ingest_end_time - ingest_start_time).count();
+    bulk_load_stats_.files += files.size();
     if (!status.ok())
         return {0, operation_status_t::error_k};
     full_compaction_.store(true);
@@ -344,11 +602,199 @@ operation_result_t rocksdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values
     return {keys.size(), operation_status_t::ok_k};
 }
 
+operation_result_t rocksdb_t::bulk_load_deferred(keys_spanc_t keys,
+                                                 values_spanc_t values,
+                                                 value_lengths_spanc_t sizes) {
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    pending_sst_t* pending = nullptr;
+    {
+        // References to the map elements stay valid on rehashing
+        std::lock_guard<std::mutex> lock(pending_ssts_mutex_);
+        pending = &pending_ssts_[std::this_thread::get_id()];
+    }
+
+    size_t offset = 0;
+    rocksdb::Status status;
+    for (size_t idx = 0; idx != keys.size() && status.ok(); ++idx) {
+        // `to_slice` swaps the bytes in place, so the native key is kept for ordering
+        key_t key = keys[idx];
+        key_t slice_key = key;
+        // `SstFileWriter` only accepts strictly increasing keys
+        if (pending->writer &&
+            (key <= pending->last_key || pending->writer->FileSize() >= bulk_load_config_.target_file_size))
+            status = finish_pending_sst(*pending);
+
+        if (status.ok() && !pending->writer) {
+            std::string sst_file_path = fmt::format("{}pending_{}.sst", sst_dir_path(), pending_ssts_count_++);
+            pending->writer =
+                std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(), options_, options_.comparator);
+            status = pending->writer->Open(sst_file_path);
+            if (status.ok())
+                pending->files.push_back(sst_file_path);
+            else
+                pending->writer.reset();
+        }
+
+        if (status.ok())
+            status = pending->writer->Put(to_slice(slice_key), to_slice(values.subspan(offset, sizes[idx])));
+        if (status.ok())
+            ++pending->entries;
+        pending->last_key = key;
+        offset += sizes[idx];
+    }
+
+    auto elapsed_time = std::chrono::high_resolution_clock::now() - start_time;
+    bulk_load_stats_.generate_ns += std::chrono::nanoseconds(elapsed_time).count();
+    if (!status.ok())
+        return {0, operation_status_t::error_k};
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+rocksdb::Status rocksdb_t::finish_pending_sst(pending_sst_t& pending) {
+    rocksdb::Status status = pending.writer->Finish();
+    pending.writer.reset();
+    return status;
+}
+
+void rocksdb_t::ingest_pending_ssts() {
+    std::lock_guard<std::mutex> lock(pending_ssts_mutex_);
+    if (pending_ssts_.empty())
+        return;
+
+    // Finishing the last files of each thread is still a part of generation
+    auto start_time = std::chrono::high_resolution_clock::now();
+    rocksdb::Status status;
+    std::vector<std::string> files;
+    size_t entries = 0;
+    for (auto& [thread_id, pending] : pending_ssts_) {
+        entries += pending.entries;
+        if (pending.writer) {
+            rocksdb::Status finish_status = finish_pending_sst(pending);
+            if (status.ok())
+                status = finish_status;
+        }
+        files.insert(files.end(), pending.files.begin(), pending.files.end());
+    }
+    pending_ssts_.clear();
+
+    auto ingest_start_time = std::chrono::high_resolution_clock::now();
+    if (status.ok() && !files.empty()) {
+        rocksdb::IngestExternalFileOptions ingest_options;
+        ingest_options.move_files = true;
+        ingest_options.ingest_behind = bulk_load_config_.ingest_behind;
+        status = db_->IngestExternalFile(files, ingest_options);
+    }
+    auto ingest_end_time = std::chrono::high_resolution_clock::now();
+    for (auto const& file_path : files)
+        fs::remove(file_path);
+
+    bulk_load_stats_.generate_ns += std::chrono::nanoseconds(ingest_start_time - start_time).count();
+    bulk_load_stats_.ingest_ns += std::chrono::nanoseconds(ingest_end_time - ingest_start_time).count();
+    bulk_load_stats_.files += files.size();
+    if (!status.ok()) {
+        // Batches were already reported as loaded, so the lost entries are accounted here
+        bulk_load_stats_.failed_entries += entries;
+        fmt::print("RocksDB: Deferred ingestion failed: {}\n", status.ToString());
+        return;
+    }
+    if (bulk_load_config_.compact)
+        full_compaction_.store(true);
+}
+
+bool rocksdb_t::apply_blob_options(rocksdb::ColumnFamilyOptions& cf_options, std::string& error) {
+    if (!blob_config_.enable)
+        return true;
+
+    if (blob_config_.compression == "none")
+        cf_options.blob_compression_type = rocksdb::kNoCompression;
+    else if (blob_config_.compression == "snappy")
+        cf_options.blob_compression_type = rocksdb::kSnappyCompression;
+    else if (blob_config_.compression == "lz4")
+        cf_options.blob_compression_type = rocksdb::kLZ4Compression;
+    else if (blob_config_.compression == "zstd")
+        cf_options.blob_compression_type = rocksdb::kZSTD;
+    else {
+        error = fmt::format("Unknown blob compression: {}", blob_config_.compression);
+        return false;
+    }
+
+    cf_options.enable_blob_files = true;
+    cf_options.min_blob_size = blob_config_.min_blob_size;
+    cf_options.blob_file_size = blob_config_.blob_file_size;
+    cf_options.enable_blob_garbage_collection = blob_config_.garbage_collection;
+    cf_options.blob_garbage_collection_age_cutoff = blob_config_.garbage_collection_age_cutoff;
+    cf_options.blob_garbage_collection_force_threshold = blob_config_.garbage_collection_force_threshold;
+    return true;
+}
+
+void rocksdb_t::catch_up_with_primary() {
+    auto interval = std::chrono::milliseconds(replica_config_.catch_up_interval_ms);
+    std::unique_lock<std::mutex> lock(catch_up_mutex_);
+    while (!catch_up_condition_.wait_for(lock, interval, [&] { return catch_up_stop_; })) {
+        rocksdb::SequenceNumber sequence = db_->GetLatestSequenceNumber();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        rocksdb::Status status = db_->TryCatchUpWithPrimary();
+        auto elapsed_ns = size_t(std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - start_time).count());
+        if (!status.ok())
+            continue;
+
+        size_t lag = size_t(db_->GetLatestSequenceNumber() - sequence);
+        ++catch_up_stats_.count;
+        catch_up_stats_.total_ns += elapsed_ns;
+        if (elapsed_ns > catch_up_stats_.max_ns)
+            catch_up_stats_.max_ns = elapsed_ns;
+        catch_up_stats_.total_lag += lag;
+        if (lag > catch_up_stats_.max_lag)
+            catch_up_stats_.max_lag = lag;
+    }
+}
+
+rocksdb::Iterator* rocksdb_t::pooled_iterator(key_t upper_bound_key) const {
+    pooled_iterator_t& pooled = pooled_iterators_.local();
+
+    // The iterator references the bound, so it's updated in place
+    pooled.upper_bound_key = upper_bound_key;
+    pooled.upper_bound = to_slice(pooled.upper_bound_key);
+    if (pooled.iterator && pooled.iterator->Refresh().ok())
+        return pooled.iterator.get();
+
+    rocksdb::ReadOptions options = range_select_options_;
+    if (range_select_config_.upper_bound)
+        options.iterate_upper_bound = &pooled.upper_bound;
+    pooled.iterator.reset(db_->NewIterator(options, cf_handles_.front()));
+    return pooled.iterator.get();
+}
+
+std::string rocksdb_t::sst_dir_path() const {
+    if (!storage_dir_paths_.empty())
+        return storage_dir_paths_.front().string();
+    return main_dir_path_.string();
+}
+
 operation_result_t rocksdb_t::range_select(key_t key, size_t length, values_span_t values) const {
 
+    key_t upper_bound_key = key + length;
+    if (upper_bound_key < key)
+        upper_bound_key = std::numeric_limits<key_t>::max();
+
+    rocksdb::Iterator* it = nullptr;
+    std::unique_ptr<rocksdb::Iterator> owned_it;
+    rocksdb::Slice upper_bound;
+    if (range_select_config_.pooled_iterators)
+        it = pooled_iterator(upper_bound_key);
+    else {
+        rocksdb::ReadOptions options = range_select_options_;
+        if (range_select_config_.upper_bound) {
+            upper_bound = to_slice(upper_bound_key);
+            options.iterate_upper_bound = &upper_bound;
+        }
+        owned_it.reset(db_->NewIterator(options, cf_handles_.front()));
+        it = owned_it.get();
+    }
+
     size_t i = 0;
     size_t exported_bytes = 0;
-    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options_));
     it->Seek(to_slice(key));
     for (; it->Valid() && i != length; i++, it->Next()) {
         memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
@@ -374,11 +820,15 @@ operation_result_t rocksdb_t::scan(key_t key, size_t length, value_span_t single
 std::string rocksdb_t::info() { return fmt::format("v{}.{}", rocksdb::kMajorVersion, rocksdb::kMinorVersion); }
 
 void rocksdb_t::flush() {
+    ingest_pending_ssts();
     db_->Flush(rocksdb::FlushOptions());
     if (full_compaction_.load()) {
+        auto start_time = std::chrono::high_resolution_clock::now();
         auto options = rocksdb::CompactRangeOptions();
         options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForceOptimized;
         db_->CompactRange(options, nullptr, nullptr);
+        auto elapsed_time = std::chrono::high_resolution_clock::now() - start_time;
+        bulk_load_stats_.compact_ns += std::chrono::nanoseconds(elapsed_time).count();
     }
 }
 
@@ -391,8 +841,75 @@ size_t rocksdb_t::size_on_disk() const {
     return files_size;
 }
 
+db_counters_t rocksdb_t::counters() {
+    db_counters_t counters;
+    size_t generate_ns = bulk_load_stats_.generate_ns.exchange(0);
+    size_t ingest_ns = bulk_load_stats_.ingest_ns.exchange(0);
+    size_t compact_ns = bulk_load_stats_.compact_ns.exchange(0);
+    size_t ingested_files = bulk_load_stats_.files.exchange(0);
+    size_t failed_entries = bulk_load_stats_.failed_entries.exchange(0);
+    if (failed_entries)
+        counters["bulk_load_failed_entries"] = double(failed_entries);
+    if (ingested_files) {
+        // Generation runs in parallel, so it is the sum over all threads
+        counters["bulk_load_generate(threads),ms"] = generate_ns / 1e6;
+        counters["bulk_load_ingest,ms"] = ingest_ns / 1e6;
+        counters["bulk_load_files"] = double(ingested_files);
+    }
+    if (compact_ns)
+        counters["compaction,ms"] = compact_ns / 1e6;
+
+    if (blob_config_.enable && options_.statistics) {
+        rocksdb::Statistics& statistics = *options_.statistics;
+        counters["blob_read,bytes"] = statistics.getAndResetTickerCount(rocksdb::BLOB_DB_BLOB_FILE_BYTES_READ);
+        counters["blob_written,bytes"] = statistics.getAndResetTickerCount(rocksdb::BLOB_DB_BLOB_FILE_BYTES_WRITTEN);
+        counters["blob_gc_relocated"] = statistics.getAndResetTickerCount(rocksdb::BLOB_DB_GC_NUM_KEYS_RELOCATED);
+        counters["blob_gc_relocated,bytes"] = statistics.getAndResetTickerCount(rocksdb::BLOB_DB_GC_BYTES_RELOCATED);
+    }
+
+    size_t catch_ups = catch_up_stats_.count.exchange(0);
+    size_t catch_up_ns = catch_up_stats_.total_ns.exchange(0);
+    size_t catch_up_max_ns = catch_up_stats_.max_ns.exchange(0);
+    size_t catch_up_lag = catch_up_stats_.total_lag.exchange(0);
+    size_t catch_up_max_lag = catch_up_stats_.max_lag.exchange(0);
+    if (catch_ups) {
+        counters["catch_ups"] = double(catch_ups);
+        counters["catch_up_avg,ms"] = catch_up_ns / 1e6 / catch_ups;
+        counters["catch_up_max,ms"] = catch_up_max_ns / 1e6;
+        counters["catch_up_lag_avg,writes"] = double(catch_up_lag) / catch_ups;
+        counters["catch_up_lag_max,writes"] = double(catch_up_max_lag);
+        // Not measured: new writes become visible after an interval and a catch-up at most
+        counters["catch_up_staleness_bound,ms"] = replica_config_.catch_up_interval_ms + catch_up_max_ns / 1e6;
+    }
+
+    if (mode_ == db_mode_t::optimistic_k) {
+        counters["transaction_commits"] = double(optimistic_stats_.commits.exchange(0));
+        counters["transaction_conflicts"] = double(optimistic_stats_.conflicts.exchange(0));
+        counters["transaction_aborts"] = double(optimistic_stats_.aborts.exchange(0));
+    }
+
+    size_t batches = multiget_stats_.batches.exchange(0);
+    size_t block_reads = multiget_stats_.block_reads.exchange(0);
+    size_t block_read_ns = multiget_stats_.block_read_ns.exchange(0);
+    size_t wall_ns = multiget_stats_.wall_ns.exchange(0);
+    if (!batches)
+        return counters;
+
+    counters["multiget_block_reads/batch"] = double(block_reads) / batches;
+    counters["multiget_latency,us"] = wall_ns / 1000.0 / batches;
+    counters["multiget_io_parallelism"] = wall_ns ? double(block_read_ns) / wall_ns : 0.0;
+    return counters;
+}
+
 std::unique_ptr<transaction_t> rocksdb_t::create_transaction() {
 
+    if (mode_ == db_mode_t::optimistic_k)
+        return std::make_unique<rocksdb_optimistic_transaction_t>(optimistic_db_,
+                                                                  cf_handles_,
+                                                                  write_options_,
+                                                                  optimistic_max_retries_,
+                                                                  optimistic_stats_);
+
     std::unique_ptr<rocksdb::Transaction> raw(transaction_db_->BeginTransaction(write_options_));
     auto id = size_t(raw.get());
     raw->SetName(std::to_string(id));
@@ -426,7 +943,139 @@ bool rocksdb_t::load_additional_options() {
     if (transaction_options_.default_write_batch_flush_threshold > 0)
         transaction_options_.write_policy = rocksdb::TxnDBWritePolicy::WRITE_UNPREPARED;
 
+    // Transactional runs switch between lock-based and validation-based concurrency
+    nlohmann::json j_optimistic = j_config.value("optimistic_transactions", nlohmann::json::object());
+    if (mode_ == db_mode_t::transactional_k && j_optimistic.value<bool>("enable", false))
+        mode_ = db_mode_t::optimistic_k;
+    optimistic_max_retries_ = j_optimistic.value<size_t>("max_retries", size_t(10));
+
+    // Asynchronous `MultiGet` reads blocks of different files in parallel, while
+    // `optimize_multiget_for_io` extends it to the files of different levels.
+    // Both are no-ops, unless RocksDB is built with `USE_COROUTINES` on top of folly,
+    // which `cmake/rocksdb.cmake` doesn't do, so such configs are rejected.
+    // Reads within a single file are still parallel with `UCSB_ROCKSDB_WITH_LIBURING`.
+    // https://github.com/facebook/rocksdb/wiki/Asynchronous-IO
+    nlohmann::json j_multiget = j_config.value("multiget", nlohmann::json::object());
+    if (j_multiget.value<bool>("async_io", false) || j_multiget.value<bool>("optimize_for_io", false)) {
+        fmt::print("RocksDB: Asynchronous MultiGet requires a build with coroutines\n");
+        return false;
+    }
+    multiget_options_ = rocksdb::ReadOptions();
+    multiget_io_stats_ = j_multiget.value<bool>("io_stats", false);
+
+    bulk_load_config_ = bulk_load_config_t();
+    nlohmann::json j_bulk_load = j_config.value("bulk_load", nlohmann::json::object());
+    bulk_load_config_.deferred_ingestion = j_bulk_load.value<bool>("deferred_ingestion", false);
+    bulk_load_config_.target_file_size =
+        j_bulk_load.value<size_t>("target_file_size", bulk_load_config_.target_file_size);
+    bulk_load_config_.ingest_behind = j_bulk_load.value<bool>("ingest_behind", false);
+    bulk_load_config_.compact = j_bulk_load.value<bool>("compact", true);
+
+    blob_config_ = blob_config_t();
+    nlohmann::json j_blob = j_config.value("blob", nlohmann::json::object());
+    blob_config_.enable = j_blob.value<bool>("enable", false);
+    blob_config_.min_blob_size = j_blob.value<size_t>("min_blob_size", blob_config_.min_blob_size);
+    blob_config_.blob_file_size = j_blob.value<size_t>("blob_file_size", blob_config_.blob_file_size);
+    blob_config_.compression = j_blob.value<std::string>("compression", blob_config_.compression);
+    blob_config_.garbage_collection = j_blob.value<bool>("garbage_collection", blob_config_.garbage_collection);
+    blob_config_.garbage_collection_age_cutoff =
+        j_blob.value<double>("garbage_collection_age_cutoff", blob_config_.garbage_collection_age_cutoff);
+    blob_config_.garbage_collection_force_threshold =
+        j_blob.value<double>("garbage_collection_force_threshold", blob_config_.garbage_collection_force_threshold);
+
+    replica_config_ = replica_config_t();
+    nlohmann::json j_replica = j_config.value("replica", nlohmann::json::object());
+    replica_config_.mode = j_replica.value<std::string>("mode", replica_config_.mode);
+    replica_config_.catch_up_interval_ms =
+        j_replica.value<size_t>("catch_up_interval_ms", replica_config_.catch_up_interval_ms);
+
+    range_select_config_ = range_select_config_t();
+    nlohmann::json j_range_select = j_config.value("range_select", nlohmann::json::object());
+    range_select_config_.pooled_iterators = j_range_select.value<bool>("pooled_iterators", true);
+    range_select_config_.upper_bound = j_range_select.value<bool>("upper_bound", false);
+    range_select_config_.readahead_size = j_range_select.value<size_t>("readahead_size", size_t(0));
+
+    table_config_ = table_config_t();
+    nlohmann::json j_table = j_config.value("table", nlohmann::json::object());
+    table_config_.factory = j_table.value<std::string>("factory", "");
+    table_config_.cache = j_table.value<std::string>("cache", "");
+    table_config_.cache_size = j_table.value<size_t>("cache_size", size_t(0));
+    table_config_.filter = j_table.value<std::string>("filter", "");
+    table_config_.filter_bits_per_key = j_table.value<double>("filter_bits_per_key", 10.0);
+    table_config_.partitioned_index_filters = j_table.value<bool>("partitioned_index_filters", false);
+
+    return true;
+}
+
+bool rocksdb_t::apply_table_options(rocksdb::ColumnFamilyOptions& cf_options, std::string& error) {
+
+    // In-memory point lookup formats, both require `mmap` reads.
+    // https://github.com/facebook/rocksdb/wiki/PlainTable-Format
+    // https://github.com/facebook/rocksdb/wiki/CuckooTable-Format
+    if (table_config_.factory == "plain") {
+        rocksdb::PlainTableOptions plain_options;
+        plain_options.user_key_len = sizeof(key_t);
+        plain_options.bloom_bits_per_key = int(table_config_.filter_bits_per_key);
+        cf_options.table_factory.reset(rocksdb::NewPlainTableFactory(plain_options));
+        cf_options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(sizeof(key_t)));
+        options_.allow_mmap_reads = true;
+        return true;
+    }
+    if (table_config_.factory == "cuckoo") {
+        rocksdb::CuckooTableOptions cuckoo_options;
+        cf_options.table_factory.reset(rocksdb::NewCuckooTableFactory(cuckoo_options));
+        options_.allow_mmap_reads = true;
+        return true;
+    }
+    if (!table_config_.factory.empty() && table_config_.factory != "block_based") {
+        error = fmt::format("Unknown table factory: {}", table_config_.factory);
+        return false;
+    }
+
+    // Start from the block-based table options of the file, if any
+    rocksdb::BlockBasedTableOptions table_options;
+    if (cf_options.table_factory) {
+        auto loaded_options = cf_options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>();
+        if (loaded_options)
+            table_options = *loaded_options;
+    }
+
+    // Column families share a single cache, which scales with the dataset, unless sized explicitly
+    if (!table_config_.cache.empty() && !block_cache_) {
+        size_t capacity = table_config_.cache_size;
+        if (capacity == 0)
+            capacity = cf_options.target_file_size_base * 10;
+        if (table_config_.cache == "lru")
+            block_cache_ = rocksdb::NewLRUCache(capacity);
+        else if (table_config_.cache == "hyper_clock")
+            block_cache_ = rocksdb::HyperClockCacheOptions(capacity, table_options.block_size).MakeSharedCache();
+        else {
+            error = fmt::format("Unknown block cache: {}", table_config_.cache);
+            return false;
+        }
+    }
+    if (block_cache_)
+        table_options.block_cache = block_cache_;
+
+    if (table_config_.filter == "bloom")
+        table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(table_config_.filter_bits_per_key));
+    else if (table_config_.filter == "ribbon")
+        table_options.filter_policy.reset(rocksdb::NewRibbonFilterPolicy(table_config_.filter_bits_per_key));
+    else if (!table_config_.filter.empty()) {
+        error = fmt::format("Unknown filter policy: {}", table_config_.filter);
+        return false;
+    }
+
+    // https://github.com/facebook/rocksdb/wiki/Partitioned-Index-Filters
+    if (table_config_.partitioned_index_filters) {
+        table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+        table_options.partition_filters = true;
+        table_options.cache_index_and_filter_blocks = true;
+        table_options.pin_top_level_index_and_filter = true;
+    }
+
+    cf_options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
     return true;
 }
 
-} // namespace ucsb::facebook
\ No newline at end of file
+} // namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE
\ No newline at end of file
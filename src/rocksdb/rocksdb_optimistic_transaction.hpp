@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <rocksdb/utilities/optimistic_transaction_db.h>
+
+#include "src/core/types.hpp"
+#include "src/core/data_accessor.hpp"
+
+#include "rocksdb_transaction.hpp"
+
+namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE {
+
+/**
+ * @brief Outcomes of optimistic transactions, shared by all threads.
+ * Conflicts are commits, rejected by validation and retried afterwards.
+ */
+struct optimistic_transaction_stats_t {
+    std::atomic<size_t> commits = 0;
+    std::atomic<size_t> conflicts = 0;
+    std::atomic<size_t> aborts = 0;
+};
+
+/**
+ * @brief RocksDB optimistic transactional wrapper for the UCSB benchmark.
+ * Every write operation runs in its own transaction, which takes no locks
+ * and is validated on commit. On `Busy` it is replayed up to `max_retries`
+ * times. Reads go directly to the DB, as there is nothing to validate.
+ */
+class rocksdb_optimistic_transaction_t : public ucsb::transaction_t {
+  public:
+    inline rocksdb_optimistic_transaction_t(rocksdb::OptimisticTransactionDB* db,
+                                            std::vector<rocksdb::ColumnFamilyHandle*> const& cf_handles,
+                                            rocksdb::WriteOptions const& write_options,
+                                            size_t max_retries,
+                                            optimistic_transaction_stats_t& stats)
+        : db_(db), cf_handles_(cf_handles), write_options_(write_options), max_retries_(max_retries),
+          stats_(&stats) {
+        read_options_.verify_checksums = false;
+    }
+    ~rocksdb_optimistic_transaction_t();
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+  private:
+    template <typename operations_at>
+    rocksdb::Status commit_with_retries(operations_at&& operations);
+
+    rocksdb::OptimisticTransactionDB* db_;
+    std::vector<rocksdb::ColumnFamilyHandle*> cf_handles_;
+    rocksdb::WriteOptions write_options_;
+    rocksdb::OptimisticTransactionOptions transaction_options_;
+    rocksdb::ReadOptions read_options_;
+    size_t max_retries_;
+    optimistic_transaction_stats_t* stats_;
+
+    std::unique_ptr<rocksdb::Transaction> transaction_;
+};
+
+rocksdb_optimistic_transaction_t::~rocksdb_optimistic_transaction_t() {
+    transaction_batch_keys.clear();
+    transaction_key_slices.clear();
+    transaction_value_slices.clear();
+    transaction_statuses.clear();
+}
+
+template <typename operations_at>
+rocksdb::Status rocksdb_optimistic_transaction_t::commit_with_retries(operations_at&& operations) {
+    rocksdb::Status status;
+    for (size_t attempt = 0; attempt <= max_retries_; ++attempt) {
+        // Passing the previous transaction reuses its memory
+        transaction_.reset(db_->BeginTransaction(write_options_, transaction_options_, transaction_.release()));
+        status = operations(*transaction_);
+        if (!status.ok()) {
+            transaction_->Rollback();
+            if (!status.IsNotFound())
+                ++stats_->aborts;
+            return status;
+        }
+
+        status = transaction_->Commit();
+        if (status.ok()) {
+            ++stats_->commits;
+            return status;
+        }
+        if (!status.IsBusy() && !status.IsTryAgain())
+            break;
+        ++stats_->conflicts;
+    }
+
+    ++stats_->aborts;
+    return status;
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::upsert(key_t key, value_spanc_t value) {
+    rocksdb::Status status = commit_with_retries([&](rocksdb::Transaction& transaction) {
+        key_t key_to_write = key;
+        return transaction.Put(to_slice(key_to_write), to_slice(value));
+    });
+    return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::update(key_t key, value_spanc_t value) {
+    rocksdb::Status status = commit_with_retries([&](rocksdb::Transaction& transaction) {
+        key_t key_to_read = key;
+        key_t key_to_write = key;
+        // Tracks the key, so a concurrent change fails the validation
+        rocksdb::PinnableSlice data;
+        rocksdb::Status status =
+            transaction.GetForUpdate(read_options_, cf_handles_.front(), to_slice(key_to_read), &data);
+        if (!status.ok())
+            return status;
+        return transaction.Put(to_slice(key_to_write), to_slice(value));
+    });
+    if (status.IsNotFound())
+        return {0, operation_status_t::not_found_k};
+    return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::remove(key_t key) {
+    rocksdb::Status status = commit_with_retries([&](rocksdb::Transaction& transaction) {
+        key_t key_to_remove = key;
+        return transaction.Delete(to_slice(key_to_remove));
+    });
+    return {size_t(status.ok()), status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::read(key_t key, value_span_t value) const {
+    rocksdb::PinnableSlice data;
+    rocksdb::Status status = db_->Get(read_options_, cf_handles_.front(), to_slice(key), &data);
+    if (status.IsNotFound())
+        return {0, operation_status_t::not_found_k};
+    else if (!status.ok())
+        return {0, operation_status_t::error_k};
+
+    memcpy(value.data(), data.data(), data.size());
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::batch_upsert(keys_spanc_t keys,
+                                                                  values_spanc_t values,
+                                                                  value_lengths_spanc_t sizes) {
+
+    rocksdb::Status status = commit_with_retries([&](rocksdb::Transaction& transaction) {
+        rocksdb::Status status;
+        size_t offset = 0;
+        for (size_t idx = 0; idx < keys.size() && status.ok(); ++idx) {
+            key_t key = keys[idx];
+            status = transaction.Put(to_slice(key), to_slice(values.subspan(offset, sizes[idx])));
+            offset += sizes[idx];
+        }
+        return status;
+    });
+    return {status.ok() ? keys.size() : 0, status.ok() ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+
+    if (keys.size() > transaction_batch_keys.size()) {
+        transaction_batch_keys.resize(keys.size());
+        transaction_key_slices.resize(keys.size());
+        transaction_value_slices.resize(keys.size());
+        transaction_statuses.resize(keys.size());
+    }
+
+    for (size_t idx = 0; idx < keys.size(); ++idx)
+        transaction_key_slices[idx] = to_slice(transaction_batch_keys[idx] = keys[idx]);
+
+    db_->MultiGet(read_options_,
+                  cf_handles_.front(),
+                  keys.size(),
+                  transaction_key_slices.data(),
+                  transaction_value_slices.data(),
+                  transaction_statuses.data());
+
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (!transaction_statuses[i].ok())
+            continue;
+
+        memcpy(values.data() + offset, transaction_value_slices[i].data(), transaction_value_slices[i].size());
+        offset += transaction_value_slices[i].size();
+        ++found_cnt;
+    }
+
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::bulk_load(keys_spanc_t keys,
+                                                               values_spanc_t values,
+                                                               value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::range_select(key_t key,
+                                                                  size_t length,
+                                                                  values_span_t values) const {
+
+    size_t i = 0;
+    size_t exported_bytes = 0;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_options_, cf_handles_.front()));
+    it->Seek(to_slice(key));
+    for (; it->Valid() && i != length; i++, it->Next()) {
+        memcpy(values.data() + exported_bytes, it->value().data(), it->value().size());
+        exported_bytes += it->value().size();
+    }
+    return {i, operation_status_t::ok_k};
+}
+
+operation_result_t rocksdb_optimistic_transaction_t::scan(key_t key, size_t length, value_span_t single_value) const {
+
+    size_t i = 0;
+    rocksdb::ReadOptions scan_options = read_options_;
+    scan_options.fill_cache = false;
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(scan_options, cf_handles_.front()));
+    it->Seek(to_slice(key));
+    for (; it->Valid() && i != length; i++, it->Next())
+        memcpy(single_value.data(), it->value().data(), it->value().size());
+    return {i, operation_status_t::ok_k};
+}
+
+} // namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE
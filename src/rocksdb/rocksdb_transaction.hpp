@@ -8,7 +8,7 @@
 #include "src/core/types.hpp"
 #include "src/core/data_accessor.hpp"
 
-namespace ucsb::facebook {
+namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE {
 
 namespace fs = ucsb::fs;
 
@@ -223,4 +223,4 @@ operation_result_t rocksdb_transaction_t::scan(key_t key, size_t length, value_s
     return {i, operation_status_t::ok_k};
 }
 
-} // namespace ucsb::facebook
+} // namespace ucsb::UCSB_ROCKSDB_WRAPPER_NAMESPACE
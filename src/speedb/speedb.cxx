@@ -0,0 +1,23 @@
+/**
+ * The RocksDB wrapper, compiled against the Speedb headers.
+ * The library is built with `ROCKSDB_NAMESPACE=speedb`, and so is this file,
+ * so its symbols don't collide with RocksDB, when both are linked together.
+ */
+
+#include <rocksdb/rocksdb_namespace.h>
+
+namespace ROCKSDB_NAMESPACE {}
+namespace rocksdb = ::ROCKSDB_NAMESPACE;
+
+#define UCSB_ROCKSDB_WRAPPER_NAMESPACE speedb
+#include "src/rocksdb/rocksdb.hpp"
+
+#include "src/speedb/speedb.hpp"
+
+namespace ucsb::speedb {
+
+std::shared_ptr<db_t> make_db(bool transactional) {
+    return std::make_shared<rocksdb_t>(transactional ? db_mode_t::transactional_k : db_mode_t::regular_k);
+}
+
+} // namespace ucsb::speedb
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <memory>
+
+#include "src/core/db.hpp"
+
+namespace ucsb::speedb {
+
+/**
+ * @brief Speedb wrapper for the UCSB benchmark.
+ * Speedb is a fork of RocksDB with the same API and even the same header paths,
+ * so it reuses the RocksDB wrapper, compiled in a separate translation unit
+ * against Speedb headers as `ucsb::speedb::rocksdb_t`.
+ * https://github.com/speedb-io/speedb
+ */
+std::shared_ptr<db_t> make_db(bool transactional);
+
+} // namespace ucsb::speedb
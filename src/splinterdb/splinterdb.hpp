@@ -0,0 +1,410 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+extern "C" {
+#include <splinterdb/splinterdb.h>
+#include <splinterdb/default_data_config.h>
+#include <splinterdb/public_util.h>
+}
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+
+namespace ucsb::vmware {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief The default data config compares keys with `memcmp`,
+ * so native little-endian keys are stored in big-endian.
+ */
+inline slice to_slice(key_t& key) {
+    static_assert(sizeof(key_t) == sizeof(uint64_t), "Check `__builtin_bswap64`");
+    key = __builtin_bswap64(key);
+    return slice_create(sizeof(key_t), &key);
+}
+
+inline slice to_slice(std::byte const* data, size_t size) { return slice_create(size, data); }
+
+/**
+ * @brief Bumped on every `open` and `close`, so threads never deregister from a closed DB.
+ */
+inline std::atomic<size_t> open_epoch = 0;
+
+/**
+ * @brief SplinterDB serves only registered threads, and the number of their slots is limited.
+ * A thread can only deregister itself, so it's done on thread exit,
+ * as benchmark threads are recreated for every workload.
+ */
+struct thread_registration_t {
+    splinterdb* db = nullptr;
+    size_t epoch = 0;
+
+    ~thread_registration_t() {
+        if (db && epoch == open_epoch.load())
+            splinterdb_deregister_thread(db);
+    }
+};
+
+thread_local thread_registration_t thread_registration;
+
+/**
+ * @brief SplinterDB wrapper for the UCSB benchmark.
+ * It has no native batches, so those are imitated with single-entry operations.
+ * https://github.com/vmware/splinterdb
+ */
+class splinterdb_t : public ucsb::db_t {
+  public:
+    inline splinterdb_t() : db_(nullptr), epoch_(0) {}
+    ~splinterdb_t() { close(); }
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    /**
+     * @brief Zero sizes and counts keep the library defaults.
+     */
+    struct config_t {
+        size_t cache_size = 0;
+        /**
+         * @brief Upper bound of the device file. Zero derives it from the dataset size.
+         */
+        size_t disk_size = 0;
+        size_t page_size = 0;
+        size_t extent_size = 0;
+        size_t memtable_capacity = 0;
+        size_t fanout = 0;
+        size_t max_branches_per_node = 0;
+        size_t num_memtable_bg_threads = 0;
+        size_t num_normal_bg_threads = 0;
+        bool use_log = false;
+    };
+
+    bool load_config(config_t& config);
+    void register_thread() const;
+    bool lookup(key_t key, value_span_t buffer, size_t& length, int& res) const;
+
+    fs::path config_path_;
+    fs::path main_dir_path_;
+    std::vector<fs::path> storage_dir_paths_;
+    db_hints_t hints_;
+    config_t config_;
+
+    std::string file_path_;
+    data_config data_config_;
+    splinterdb_config splinterdb_config_;
+    splinterdb* db_;
+    size_t epoch_;
+};
+
+void splinterdb_t::set_config(fs::path const& config_path,
+                              fs::path const& main_dir_path,
+                              std::vector<fs::path> const& storage_dir_paths,
+                              db_hints_t const& hints) {
+    config_path_ = config_path;
+    main_dir_path_ = main_dir_path;
+    storage_dir_paths_ = storage_dir_paths;
+    hints_ = hints;
+}
+
+bool splinterdb_t::open(std::string& error) {
+    if (db_)
+        return true;
+
+    if (!storage_dir_paths_.empty()) {
+        error = "Doesn't support multiple disks";
+        return false;
+    }
+
+    if (!load_config(config_)) {
+        error = "Failed to load config";
+        return false;
+    }
+
+    size_t disk_size = config_.disk_size;
+    if (!disk_size) {
+        // Leave room for compactions and space amplification, the file is sparse anyway
+        size_t dataset_size = hints_.records_count * (sizeof(key_t) + hints_.value_length);
+        disk_size = std::max(dataset_size * 4, size_t(1) << 30);
+    }
+
+    default_data_config_init(sizeof(key_t), &data_config_);
+    file_path_ = (main_dir_path_ / "ucsb.splinterdb").string();
+    splinterdb_config_ = {};
+    splinterdb_config_.filename = file_path_.c_str();
+    splinterdb_config_.cache_size = config_.cache_size;
+    splinterdb_config_.disk_size = disk_size;
+    splinterdb_config_.data_cfg = &data_config_;
+    splinterdb_config_.page_size = config_.page_size;
+    splinterdb_config_.extent_size = config_.extent_size;
+    splinterdb_config_.memtable_capacity = config_.memtable_capacity;
+    splinterdb_config_.fanout = config_.fanout;
+    splinterdb_config_.max_branches_per_node = config_.max_branches_per_node;
+    splinterdb_config_.num_memtable_bg_threads = config_.num_memtable_bg_threads;
+    splinterdb_config_.num_normal_bg_threads = config_.num_normal_bg_threads;
+    splinterdb_config_.use_log = config_.use_log;
+
+    int res = fs::exists(file_path_) ? splinterdb_open(&splinterdb_config_, &db_)
+                                     : splinterdb_create(&splinterdb_config_, &db_);
+    if (res) {
+        db_ = nullptr;
+        error = fmt::format("Failed to open DB: {}", res);
+        return false;
+    }
+
+    // The opening thread is registered implicitly
+    epoch_ = ++open_epoch;
+    thread_registration.db = db_;
+    thread_registration.epoch = epoch_;
+    return true;
+}
+
+void splinterdb_t::close() {
+    if (!db_)
+        return;
+
+    ++open_epoch;
+    splinterdb_close(&db_);
+    db_ = nullptr;
+}
+
+void splinterdb_t::register_thread() const {
+    if (thread_registration.db == db_ && thread_registration.epoch == epoch_)
+        return;
+    splinterdb_register_thread(db_);
+    thread_registration.db = db_;
+    thread_registration.epoch = epoch_;
+}
+
+bool splinterdb_t::lookup(key_t key, value_span_t buffer, size_t& length, int& res) const {
+    // The result is read straight into the output, unless it doesn't fit
+    splinterdb_lookup_result result;
+    splinterdb_lookup_result_init(db_, &result, buffer.size(), reinterpret_cast<char*>(buffer.data()));
+    res = splinterdb_lookup(db_, to_slice(key), &result);
+    bool found = res == 0 && splinterdb_lookup_found(&result);
+    if (found) {
+        slice found_value;
+        res = splinterdb_lookup_result_value(&result, &found_value);
+        found = res == 0;
+        length = found ? slice_length(found_value) : 0;
+        if (found && slice_data(found_value) != buffer.data())
+            memcpy(buffer.data(), slice_data(found_value), length);
+    }
+    splinterdb_lookup_result_deinit(&result);
+    return found;
+}
+
+operation_result_t splinterdb_t::upsert(key_t key, value_spanc_t value) {
+    register_thread();
+    int res = splinterdb_insert(db_, to_slice(key), to_slice(value.data(), value.size()));
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t splinterdb_t::update(key_t key, value_spanc_t value) {
+    register_thread();
+
+    // `splinterdb_update` applies a delta through the merge callbacks of the data config,
+    // which the default one doesn't have, so check the presence and overwrite instead
+    splinterdb_lookup_result result;
+    splinterdb_lookup_result_init(db_, &result, 0, nullptr);
+    key_t lookup_key = key;
+    int res = splinterdb_lookup(db_, to_slice(lookup_key), &result);
+    bool found = res == 0 && splinterdb_lookup_found(&result);
+    splinterdb_lookup_result_deinit(&result);
+    if (res)
+        return {0, operation_status_t::error_k};
+    if (!found)
+        return {0, operation_status_t::not_found_k};
+
+    res = splinterdb_insert(db_, to_slice(key), to_slice(value.data(), value.size()));
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t splinterdb_t::remove(key_t key) {
+    register_thread();
+    int res = splinterdb_delete(db_, to_slice(key));
+    return {size_t(res == 0), res == 0 ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t splinterdb_t::read(key_t key, value_span_t value) const {
+    register_thread();
+    int res = 0;
+    size_t length = 0;
+    if (lookup(key, value, length, res))
+        return {1, operation_status_t::ok_k};
+    return {0, res ? operation_status_t::error_k : operation_status_t::not_found_k};
+}
+
+operation_result_t splinterdb_t::batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    register_thread();
+
+    // Note: imitation of batch upsert!
+    size_t offset = 0;
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        key_t key = keys[idx];
+        int res = splinterdb_insert(db_, to_slice(key), to_slice(values.data() + offset, sizes[idx]));
+        if (res)
+            return {idx, operation_status_t::error_k};
+        offset += sizes[idx];
+    }
+
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t splinterdb_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    register_thread();
+
+    // Note: imitation of batch read!
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key : keys) {
+        int res = 0;
+        size_t length = 0;
+        if (!lookup(key, values.subspan(offset), length, res))
+            continue;
+        offset += length;
+        ++found_cnt;
+    }
+
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t splinterdb_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t splinterdb_t::range_select(key_t key, size_t length, values_span_t values) const {
+    register_thread();
+
+    splinterdb_iterator* iter = nullptr;
+    int res = splinterdb_iterator_init(db_, &iter, to_slice(key));
+    if (res)
+        return {0, operation_status_t::error_k};
+
+    size_t offset = 0;
+    size_t selected_records_count = 0;
+    for (; splinterdb_iterator_valid(iter) && selected_records_count != length; ++selected_records_count) {
+        slice found_key, found_value;
+        splinterdb_iterator_get_current(iter, &found_key, &found_value);
+        memcpy(values.data() + offset, slice_data(found_value), slice_length(found_value));
+        offset += slice_length(found_value);
+        splinterdb_iterator_next(iter);
+    }
+
+    res = splinterdb_iterator_status(iter);
+    splinterdb_iterator_deinit(iter);
+    if (res)
+        return {0, operation_status_t::error_k};
+    return {selected_records_count,
+            selected_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+operation_result_t splinterdb_t::scan(key_t key, size_t length, value_span_t single_value) const {
+    register_thread();
+
+    splinterdb_iterator* iter = nullptr;
+    int res = splinterdb_iterator_init(db_, &iter, to_slice(key));
+    if (res)
+        return {0, operation_status_t::error_k};
+
+    size_t scanned_records_count = 0;
+    for (; splinterdb_iterator_valid(iter) && scanned_records_count != length; ++scanned_records_count) {
+        slice found_key, found_value;
+        splinterdb_iterator_get_current(iter, &found_key, &found_value);
+        memcpy(single_value.data(), slice_data(found_value), slice_length(found_value));
+        splinterdb_iterator_next(iter);
+    }
+
+    res = splinterdb_iterator_status(iter);
+    splinterdb_iterator_deinit(iter);
+    if (res)
+        return {0, operation_status_t::error_k};
+    return {scanned_records_count,
+            scanned_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+std::string splinterdb_t::info() { return fmt::format("cache: {}MB", config_.cache_size >> 20); }
+
+void splinterdb_t::flush() {
+    // There is no public API to force memtables out, they reach the disk on `close`
+}
+
+/**
+ * @brief The device file is sparse, so its length says nothing about the written data.
+ */
+size_t splinterdb_t::size_on_disk() const { return ucsb::allocated_size_on_disk(main_dir_path_); }
+
+std::unique_ptr<transaction_t> splinterdb_t::create_transaction() { return {}; }
+
+bool splinterdb_t::load_config(config_t& config) {
+    if (!fs::exists(config_path_))
+        return false;
+
+    std::ifstream i_config(config_path_);
+    nlohmann::json j_config;
+    i_config >> j_config;
+
+    config.cache_size = j_config.value<size_t>("cache_size", size_t(0));
+    config.disk_size = j_config.value<size_t>("disk_size", size_t(0));
+    config.page_size = j_config.value<size_t>("page_size", size_t(0));
+    config.extent_size = j_config.value<size_t>("extent_size", size_t(0));
+    config.memtable_capacity = j_config.value<size_t>("memtable_capacity", size_t(0));
+    config.fanout = j_config.value<size_t>("fanout", size_t(0));
+    config.max_branches_per_node = j_config.value<size_t>("max_branches_per_node", size_t(0));
+    config.num_memtable_bg_threads = j_config.value<size_t>("num_memtable_bg_threads", size_t(0));
+    config.num_normal_bg_threads = j_config.value<size_t>("num_normal_bg_threads", size_t(0));
+    config.use_log = j_config.value<bool>("use_log", false);
+
+    // Unlike the other sizes, the cache has no default
+    return config.cache_size != 0;
+}
+
+} // namespace ucsb::vmware
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <sqlite3.h>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+#include "src/core/per_thread.hpp"
+
+namespace ucsb::sqlite {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief A connection with its prepared statements, one per thread,
+ * as SQLite connections can't be used concurrently.
+ */
+struct connection_t {
+    sqlite3* db = nullptr;
+    sqlite3_stmt* upsert = nullptr;
+    sqlite3_stmt* update = nullptr;
+    sqlite3_stmt* remove = nullptr;
+    sqlite3_stmt* read = nullptr;
+    sqlite3_stmt* range = nullptr;
+    sqlite3_stmt* begin_read = nullptr;
+    sqlite3_stmt* begin_write = nullptr;
+    sqlite3_stmt* commit = nullptr;
+    sqlite3_stmt* rollback = nullptr;
+
+    connection_t() = default;
+    connection_t(connection_t const&) = delete;
+    connection_t& operator=(connection_t const&) = delete;
+    ~connection_t() {
+        for (auto stmt : {upsert, update, remove, read, range, begin_read, begin_write, commit, rollback})
+            sqlite3_finalize(stmt);
+        sqlite3_close_v2(db);
+    }
+
+    operator bool() const noexcept { return db != nullptr; }
+};
+
+/**
+ * @brief Resets a statement after its results are consumed,
+ * so it releases its locks and can be reused by the next call.
+ */
+struct statement_guard_t {
+    sqlite3_stmt* stmt;
+    ~statement_guard_t() {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+};
+
+/**
+ * @brief SQLite wrapper for the UCSB benchmark.
+ * https://www.sqlite.org
+ *
+ * Uses a single `(k INTEGER PRIMARY KEY, v BLOB)` table, so keys are the rowids,
+ * optionally declared `WITHOUT ROWID`. Every thread lazily opens its own connection
+ * and prepares all the statements once. Batches run inside explicit transactions.
+ */
+class sqlite_t : public ucsb::db_t {
+  public:
+    inline sqlite_t() = default;
+    ~sqlite_t() { close(); }
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    struct config_t {
+        std::string journal_mode = "WAL";
+        std::string synchronous = "NORMAL";
+        size_t mmap_size = 0;
+        /**
+         * @brief Positive values are pages, negative ones are KiB, like in `PRAGMA cache_size`.
+         */
+        int64_t cache_size = -2000;
+        size_t page_size = 4096;
+        size_t busy_timeout_ms = 10'000;
+        bool without_rowid = false;
+        /**
+         * @brief Records committed per transaction during `bulk_load`.
+         * Zero means the whole bulk goes into a single transaction.
+         */
+        size_t bulk_load_txn_records = 0;
+    };
+
+    bool load_config(config_t& config);
+    bool open_connection(connection_t& connection, std::string& error) const;
+    connection_t* connection() const;
+    operation_result_t write_batch(keys_spanc_t keys,
+                                   values_spanc_t values,
+                                   value_lengths_spanc_t sizes,
+                                   size_t txn_records);
+
+    fs::path config_path_;
+    fs::path main_dir_path_;
+    std::vector<fs::path> storage_dir_paths_;
+    config_t config_;
+    fs::path db_path_;
+
+    connection_t primary_;
+    mutable per_thread_t<connection_t> connections_;
+};
+
+inline bool exec(sqlite3* db, std::string const& sql, std::string& error) {
+    char* message = nullptr;
+    if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &message) == SQLITE_OK)
+        return true;
+    error = message ? message : sqlite3_errmsg(db);
+    sqlite3_free(message);
+    return false;
+}
+
+inline bool step_done(sqlite3_stmt* stmt) {
+    statement_guard_t guard {stmt};
+    return sqlite3_step(stmt) == SQLITE_DONE;
+}
+
+void sqlite_t::set_config(fs::path const& config_path,
+                          fs::path const& main_dir_path,
+                          std::vector<fs::path> const& storage_dir_paths,
+                          [[maybe_unused]] db_hints_t const& hints) {
+    config_path_ = config_path;
+    main_dir_path_ = main_dir_path;
+    storage_dir_paths_ = storage_dir_paths;
+    db_path_ = main_dir_path / "ucsb.sqlite3";
+}
+
+bool sqlite_t::open(std::string& error) {
+    if (primary_)
+        return true;
+
+    if (!storage_dir_paths_.empty()) {
+        error = "Doesn't support multiple disks";
+        return false;
+    }
+    if (!load_config(config_)) {
+        error = "Failed to load config";
+        return false;
+    }
+
+    // The page size only applies before the first table is created
+    if (sqlite3_open_v2(db_path_.c_str(), &primary_.db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) !=
+        SQLITE_OK) {
+        error = primary_.db ? sqlite3_errmsg(primary_.db) : "Failed to open DB";
+        close();
+        return false;
+    }
+    sqlite3_busy_timeout(primary_.db, int(config_.busy_timeout_ms));
+    bool ok = exec(primary_.db, fmt::format("PRAGMA page_size = {};", config_.page_size), error) &&
+              exec(primary_.db, fmt::format("PRAGMA journal_mode = {};", config_.journal_mode), error) &&
+              exec(primary_.db,
+                   fmt::format("CREATE TABLE IF NOT EXISTS kv (k INTEGER PRIMARY KEY, v BLOB){};",
+                               config_.without_rowid ? " WITHOUT ROWID" : ""),
+                   error);
+    if (!ok) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void sqlite_t::close() {
+    connections_.clear();
+    if (primary_) {
+        sqlite3_close_v2(primary_.db);
+        primary_.db = nullptr;
+    }
+}
+
+bool sqlite_t::open_connection(connection_t& connection, std::string& error) const {
+    if (sqlite3_open_v2(db_path_.c_str(), &connection.db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, nullptr) !=
+        SQLITE_OK) {
+        error = connection.db ? sqlite3_errmsg(connection.db) : "Failed to open DB";
+        return false;
+    }
+    sqlite3_busy_timeout(connection.db, int(config_.busy_timeout_ms));
+
+    // Those pragmas are per connection
+    bool ok = exec(connection.db, fmt::format("PRAGMA synchronous = {};", config_.synchronous), error) &&
+              exec(connection.db, fmt::format("PRAGMA cache_size = {};", config_.cache_size), error) &&
+              exec(connection.db, fmt::format("PRAGMA mmap_size = {};", config_.mmap_size), error);
+    if (!ok)
+        return false;
+
+    auto prepare = [&](char const* sql, sqlite3_stmt*& stmt) {
+        if (sqlite3_prepare_v3(connection.db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) == SQLITE_OK)
+            return true;
+        error = sqlite3_errmsg(connection.db);
+        return false;
+    };
+    return prepare("INSERT INTO kv (k, v) VALUES (?1, ?2) ON CONFLICT (k) DO UPDATE SET v = excluded.v;",
+                   connection.upsert) &&
+           prepare("UPDATE kv SET v = ?2 WHERE k = ?1;", connection.update) &&
+           prepare("DELETE FROM kv WHERE k = ?1;", connection.remove) &&
+           prepare("SELECT v FROM kv WHERE k = ?1;", connection.read) &&
+           prepare("SELECT v FROM kv WHERE k >= ?1 ORDER BY k LIMIT ?2;", connection.range) &&
+           prepare("BEGIN DEFERRED;", connection.begin_read) && prepare("BEGIN IMMEDIATE;", connection.begin_write) &&
+           prepare("COMMIT;", connection.commit) && prepare("ROLLBACK;", connection.rollback);
+}
+
+connection_t* sqlite_t::connection() const {
+    connection_t& connection = connections_.local();
+    if (!connection) [[unlikely]] {
+        std::string error;
+        if (!open_connection(connection, error)) {
+            fmt::print("SQLite: {}\n", error);
+            return nullptr;
+        }
+    }
+    return &connection;
+}
+
+std::string sqlite_t::info() {
+    return fmt::format("v{}, {}{}",
+                       sqlite3_libversion(),
+                       config_.journal_mode,
+                       config_.without_rowid ? ", without rowid" : "");
+}
+
+operation_result_t sqlite_t::upsert(key_t key, value_spanc_t value) {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->upsert;
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    sqlite3_bind_blob(stmt, 2, value.data(), int(value.size()), SQLITE_STATIC);
+    if (!step_done(stmt))
+        return {0, operation_status_t::error_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::update(key_t key, value_spanc_t value) {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->update;
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    sqlite3_bind_blob(stmt, 2, value.data(), int(value.size()), SQLITE_STATIC);
+    if (!step_done(stmt))
+        return {0, operation_status_t::error_k};
+    if (sqlite3_changes(connection->db) == 0)
+        return {0, operation_status_t::not_found_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::remove(key_t key) {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->remove;
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    if (!step_done(stmt))
+        return {0, operation_status_t::error_k};
+    if (sqlite3_changes(connection->db) == 0)
+        return {0, operation_status_t::not_found_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::read(key_t key, value_span_t value) const {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->read;
+    statement_guard_t guard {stmt};
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    int res = sqlite3_step(stmt);
+    if (res == SQLITE_DONE)
+        return {0, operation_status_t::not_found_k};
+    if (res != SQLITE_ROW)
+        return {0, operation_status_t::error_k};
+
+    memcpy(value.data(), sqlite3_column_blob(stmt, 0), sqlite3_column_bytes(stmt, 0));
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::write_batch(keys_spanc_t keys,
+                                         values_spanc_t values,
+                                         value_lengths_spanc_t sizes,
+                                         size_t txn_records) {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    if (!txn_records)
+        txn_records = keys.size();
+    size_t offset = 0;
+    for (size_t first = 0; first < keys.size(); first += txn_records) {
+        // Immediate transactions take the write lock upfront, instead of failing to upgrade later
+        if (!step_done(connection->begin_write))
+            return {first, operation_status_t::error_k};
+
+        size_t last = std::min(first + txn_records, keys.size());
+        for (size_t idx = first; idx != last; ++idx) {
+            sqlite3_stmt* stmt = connection->upsert;
+            sqlite3_bind_int64(stmt, 1, sqlite3_int64(keys[idx]));
+            sqlite3_bind_blob(stmt, 2, values.data() + offset, int(sizes[idx]), SQLITE_STATIC);
+            offset += sizes[idx];
+            if (!step_done(stmt)) {
+                step_done(connection->rollback);
+                return {first, operation_status_t::error_k};
+            }
+        }
+
+        if (!step_done(connection->commit)) {
+            step_done(connection->rollback);
+            return {first, operation_status_t::error_k};
+        }
+    }
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return write_batch(keys, values, sizes, 0);
+}
+
+operation_result_t sqlite_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    // All lookups are served from the same snapshot, to match the semantics of a real batch
+    if (!step_done(connection->begin_read))
+        return {0, operation_status_t::error_k};
+
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    sqlite3_stmt* stmt = connection->read;
+    for (auto key : keys) {
+        statement_guard_t guard {stmt};
+        sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+        if (sqlite3_step(stmt) != SQLITE_ROW)
+            continue;
+        size_t size = sqlite3_column_bytes(stmt, 0);
+        memcpy(values.data() + offset, sqlite3_column_blob(stmt, 0), size);
+        offset += size;
+        ++found_cnt;
+    }
+
+    step_done(connection->commit);
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t sqlite_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return write_batch(keys, values, sizes, config_.bulk_load_txn_records);
+}
+
+operation_result_t sqlite_t::range_select(key_t key, size_t length, values_span_t values) const {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->range;
+    statement_guard_t guard {stmt};
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    sqlite3_bind_int64(stmt, 2, sqlite3_int64(length));
+
+    size_t i = 0;
+    size_t exported_bytes = 0;
+    int res = SQLITE_ROW;
+    for (; (res = sqlite3_step(stmt)) == SQLITE_ROW; ++i) {
+        size_t size = sqlite3_column_bytes(stmt, 0);
+        memcpy(values.data() + exported_bytes, sqlite3_column_blob(stmt, 0), size);
+        exported_bytes += size;
+    }
+    return {i, res == SQLITE_DONE ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t sqlite_t::scan(key_t key, size_t length, value_span_t single_value) const {
+    connection_t* connection = this->connection();
+    if (!connection)
+        return {0, operation_status_t::error_k};
+
+    sqlite3_stmt* stmt = connection->range;
+    statement_guard_t guard {stmt};
+    sqlite3_bind_int64(stmt, 1, sqlite3_int64(key));
+    sqlite3_bind_int64(stmt, 2, sqlite3_int64(length));
+
+    size_t i = 0;
+    int res = SQLITE_ROW;
+    for (; (res = sqlite3_step(stmt)) == SQLITE_ROW; ++i)
+        memcpy(single_value.data(), sqlite3_column_blob(stmt, 0), sqlite3_column_bytes(stmt, 0));
+    return {i, res == SQLITE_DONE ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+void sqlite_t::flush() {
+    // Moves the WAL into the main file, without waiting for readers
+    connection_t* connection = this->connection();
+    if (connection)
+        sqlite3_wal_checkpoint_v2(connection->db, nullptr, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+}
+
+size_t sqlite_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
+
+std::unique_ptr<transaction_t> sqlite_t::create_transaction() { return {}; }
+
+bool sqlite_t::load_config(config_t& config) {
+    if (!fs::exists(config_path_))
+        return false;
+
+    std::ifstream i_config(config_path_);
+    nlohmann::json j_config;
+    i_config >> j_config;
+
+    config.journal_mode = j_config.value<std::string>("journal_mode", "WAL");
+    config.synchronous = j_config.value<std::string>("synchronous", "NORMAL");
+    config.mmap_size = j_config.value<size_t>("mmap_size", size_t(0));
+    config.cache_size = j_config.value<int64_t>("cache_size", int64_t(-2000));
+    config.page_size = j_config.value<size_t>("page_size", size_t(4096));
+    config.busy_timeout_ms = j_config.value<size_t>("busy_timeout_ms", size_t(10'000));
+    config.without_rowid = j_config.value<bool>("without_rowid", false);
+    config.bulk_load_txn_records = j_config.value<size_t>("bulk_load_txn_records", size_t(0));
+
+    return true;
+}
+
+} // namespace ucsb::sqlite
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <tkrzw_lib_common.h>
+#include <tkrzw_dbm.h>
+#include <tkrzw_dbm_poly.h>
+#include <tkrzw_dbm_shard.h>
+
+#include "src/core/types.hpp"
+#include "src/core/db.hpp"
+#include "src/core/helper.hpp"
+
+namespace ucsb::dbmx {
+
+namespace fs = ucsb::fs;
+
+using key_t = ucsb::key_t;
+using keys_spanc_t = ucsb::keys_spanc_t;
+using value_span_t = ucsb::value_span_t;
+using value_spanc_t = ucsb::value_spanc_t;
+using values_span_t = ucsb::values_span_t;
+using values_spanc_t = ucsb::values_spanc_t;
+using value_lengths_spanc_t = ucsb::value_lengths_spanc_t;
+using operation_status_t = ucsb::operation_status_t;
+using operation_result_t = ucsb::operation_result_t;
+using db_hints_t = ucsb::db_hints_t;
+using transaction_t = ucsb::transaction_t;
+
+/**
+ * @brief Ordered backends compare keys lexicographically,
+ * so native little-endian keys are stored in big-endian.
+ */
+inline key_t to_ordered(key_t key) {
+    static_assert(sizeof(key_t) == sizeof(uint64_t), "Check `__builtin_bswap64`");
+    return __builtin_bswap64(key);
+}
+
+inline std::string_view to_view(key_t const& key) { return {reinterpret_cast<char const*>(&key), sizeof(key_t)}; }
+
+inline std::string_view to_view(std::byte const* data, size_t size) {
+    return {reinterpret_cast<char const*>(data), size};
+}
+
+inline bool is_noop(std::string_view value) { return value.data() == tkrzw::DBM::RecordProcessor::NOOP.data(); }
+
+/*
+ * @brief Preallocated buffers used for batch operations.
+ * Globals and especially `thread_local`s are a bad practice.
+ */
+thread_local std::vector<key_t> batch_keys;
+thread_local std::vector<std::string_view> batch_key_views;
+thread_local std::string value_buffer;
+
+/**
+ * @brief Tkrzw wrapper for the UCSB benchmark.
+ * The backend is chosen by the `dbm` config key: `HashDBM`, `TreeDBM` or `SkipDBM`,
+ * optionally split into `num_shards` files by `ShardDBM`.
+ * Unlike the ordered backends, `HashDBM` iterators visit records in storage order,
+ * so its range selects and scans aren't sorted by key.
+ * `SkipDBM` buffers updates until `Synchronize`, which happens on `flush`.
+ * https://github.com/estraier/tkrzw
+ */
+class tkrzw_t : public ucsb::db_t {
+  public:
+    inline tkrzw_t() = default;
+    ~tkrzw_t() { close(); }
+
+    void set_config(fs::path const& config_path,
+                    fs::path const& main_dir_path,
+                    std::vector<fs::path> const& storage_dir_paths,
+                    db_hints_t const& hints) override;
+    bool open(std::string& error) override;
+    void close() override;
+
+    std::string info() override;
+
+    operation_result_t upsert(key_t key, value_spanc_t value) override;
+    operation_result_t update(key_t key, value_spanc_t value) override;
+    operation_result_t remove(key_t key) override;
+    operation_result_t read(key_t key, value_span_t value) const override;
+
+    operation_result_t batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+    operation_result_t batch_read(keys_spanc_t keys, values_span_t values) const override;
+
+    operation_result_t bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) override;
+
+    operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
+    operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
+
+    void flush() override;
+
+    size_t size_on_disk() const override;
+
+    std::unique_ptr<transaction_t> create_transaction() override;
+
+  private:
+    struct config_t {
+        std::string dbm = "TreeDBM";
+        size_t num_shards = 0;
+        bool sync_hard = false;
+        /**
+         * @brief Tuning parameters, passed to `OpenAdvanced` as is.
+         * https://dbmx.net/tkrzw/api/classtkrzw_1_1PolyDBM.html
+         */
+        std::map<std::string, std::string> params;
+    };
+
+    bool load_config(config_t& config);
+
+    fs::path config_path_;
+    fs::path main_dir_path_;
+    std::vector<fs::path> storage_dir_paths_;
+    config_t config_;
+
+    std::unique_ptr<tkrzw::ParamDBM> dbm_;
+};
+
+void tkrzw_t::set_config(fs::path const& config_path,
+                         fs::path const& main_dir_path,
+                         std::vector<fs::path> const& storage_dir_paths,
+                         [[maybe_unused]] db_hints_t const& hints) {
+    config_path_ = config_path;
+    main_dir_path_ = main_dir_path;
+    storage_dir_paths_ = storage_dir_paths;
+}
+
+bool tkrzw_t::open(std::string& error) {
+    if (dbm_)
+        return true;
+
+    if (!storage_dir_paths_.empty()) {
+        error = "Doesn't support multiple disks";
+        return false;
+    }
+
+    if (!load_config(config_)) {
+        error = "Failed to load config";
+        return false;
+    }
+
+    std::map<std::string, std::string> params = config_.params;
+    params["dbm"] = config_.dbm;
+    if (config_.num_shards) {
+        params["num_shards"] = std::to_string(config_.num_shards);
+        dbm_ = std::make_unique<tkrzw::ShardDBM>();
+    }
+    else
+        dbm_ = std::make_unique<tkrzw::PolyDBM>();
+
+    fs::path path = main_dir_path_ / fmt::format("ucsb.{}", config_.dbm);
+    tkrzw::Status status = dbm_->OpenAdvanced(path.string(), true, tkrzw::File::OPEN_DEFAULT, params);
+    if (status != tkrzw::Status::SUCCESS) {
+        dbm_.reset();
+        error = status.GetMessage();
+        return false;
+    }
+
+    return true;
+}
+
+void tkrzw_t::close() {
+    if (!dbm_)
+        return;
+
+    dbm_->Close();
+    dbm_.reset();
+}
+
+operation_result_t tkrzw_t::upsert(key_t key, value_spanc_t value) {
+    key = to_ordered(key);
+    tkrzw::Status status = dbm_->Set(to_view(key), to_view(value.data(), value.size()));
+    if (status != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::error_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::update(key_t key, value_spanc_t value) {
+    key = to_ordered(key);
+    bool found = false;
+    tkrzw::Status status = dbm_->Process(
+        to_view(key),
+        [&](std::string_view, std::string_view old_value) -> std::string_view {
+            if (is_noop(old_value))
+                return tkrzw::DBM::RecordProcessor::NOOP;
+            found = true;
+            return to_view(value.data(), value.size());
+        },
+        true);
+    if (status != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::error_k};
+    if (!found)
+        return {0, operation_status_t::not_found_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::remove(key_t key) {
+    key = to_ordered(key);
+    tkrzw::Status status = dbm_->Remove(to_view(key));
+    if (status == tkrzw::Status::NOT_FOUND_ERROR)
+        return {0, operation_status_t::not_found_k};
+    if (status != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::error_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::read(key_t key, value_span_t value) const {
+    key = to_ordered(key);
+    bool found = false;
+    // Copy straight out of the record, instead of going through an `std::string`
+    tkrzw::Status status = dbm_->Process(
+        to_view(key),
+        [&](std::string_view, std::string_view stored) -> std::string_view {
+            if (!is_noop(stored)) {
+                memcpy(value.data(), stored.data(), stored.size());
+                found = true;
+            }
+            return tkrzw::DBM::RecordProcessor::NOOP;
+        },
+        false);
+    if (status != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::error_k};
+    if (!found)
+        return {0, operation_status_t::not_found_k};
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::batch_upsert(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    batch_keys.resize(keys.size());
+    std::map<std::string_view, std::string_view> records;
+    size_t offset = 0;
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        batch_keys[idx] = to_ordered(keys[idx]);
+        records.emplace(to_view(batch_keys[idx]), to_view(values.data() + offset, sizes[idx]));
+        offset += sizes[idx];
+    }
+
+    tkrzw::Status status = dbm_->SetMulti(records);
+    if (status != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::error_k};
+    return {keys.size(), operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::batch_read(keys_spanc_t keys, values_span_t values) const {
+    batch_keys.resize(keys.size());
+    batch_key_views.resize(keys.size());
+    for (size_t idx = 0; idx != keys.size(); ++idx) {
+        batch_keys[idx] = to_ordered(keys[idx]);
+        batch_key_views[idx] = to_view(batch_keys[idx]);
+    }
+
+    // Missing keys are simply absent from the result
+    std::map<std::string, std::string> records = dbm_->GetMulti(batch_key_views);
+    size_t offset = 0;
+    size_t found_cnt = 0;
+    for (auto key_view : batch_key_views) {
+        auto it = records.find(std::string(key_view));
+        if (it == records.end())
+            continue;
+        memcpy(values.data() + offset, it->second.data(), it->second.size());
+        offset += it->second.size();
+        ++found_cnt;
+    }
+
+    return {found_cnt, operation_status_t::ok_k};
+}
+
+operation_result_t tkrzw_t::bulk_load(keys_spanc_t keys, values_spanc_t values, value_lengths_spanc_t sizes) {
+    return batch_upsert(keys, values, sizes);
+}
+
+operation_result_t tkrzw_t::range_select(key_t key, size_t length, values_span_t values) const {
+    key = to_ordered(key);
+    std::unique_ptr<tkrzw::DBM::Iterator> iter = dbm_->MakeIterator();
+    if (iter->Jump(to_view(key)) != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::not_found_k};
+
+    size_t offset = 0;
+    size_t selected_records_count = 0;
+    for (; selected_records_count != length; ++selected_records_count) {
+        if (iter->Step(nullptr, &value_buffer) != tkrzw::Status::SUCCESS)
+            break;
+        memcpy(values.data() + offset, value_buffer.data(), value_buffer.size());
+        offset += value_buffer.size();
+    }
+
+    return {selected_records_count,
+            selected_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+operation_result_t tkrzw_t::scan(key_t key, size_t length, value_span_t single_value) const {
+    key = to_ordered(key);
+    std::unique_ptr<tkrzw::DBM::Iterator> iter = dbm_->MakeIterator();
+    if (iter->Jump(to_view(key)) != tkrzw::Status::SUCCESS)
+        return {0, operation_status_t::not_found_k};
+
+    size_t scanned_records_count = 0;
+    for (; scanned_records_count != length; ++scanned_records_count) {
+        if (iter->Step(nullptr, &value_buffer) != tkrzw::Status::SUCCESS)
+            break;
+        memcpy(single_value.data(), value_buffer.data(), value_buffer.size());
+    }
+
+    return {scanned_records_count,
+            scanned_records_count ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
+std::string tkrzw_t::info() { return fmt::format("v{}, {}", tkrzw::PACKAGE_VERSION, config_.dbm); }
+
+void tkrzw_t::flush() {
+    if (dbm_)
+        dbm_->Synchronize(config_.sync_hard);
+}
+
+size_t tkrzw_t::size_on_disk() const { return ucsb::size_on_disk(main_dir_path_); }
+
+std::unique_ptr<transaction_t> tkrzw_t::create_transaction() { return {}; }
+
+bool tkrzw_t::load_config(config_t& config) {
+    if (!fs::exists(config_path_))
+        return false;
+
+    std::ifstream i_config(config_path_);
+    nlohmann::json j_config;
+    i_config >> j_config;
+
+    config.dbm = j_config.value<std::string>("dbm", "TreeDBM");
+    if (config.dbm != "HashDBM" && config.dbm != "TreeDBM" && config.dbm != "SkipDBM")
+        return false;
+    config.num_shards = j_config.value<size_t>("num_shards", size_t(0));
+    config.sync_hard = j_config.value<bool>("sync_hard", false);
+
+    config.params.clear();
+    for (auto const& [name, value] : j_config.value("params", nlohmann::json::object()).items())
+        config.params[name] = value.is_string() ? value.get<std::string>() : value.dump();
+
+    return true;
+}
+
+} // namespace ucsb::dbmx
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <streambuf>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
+#include <nlohmann/json.hpp>
 #include <ustore/ustore.h>
 #include <ustore/cpp/status.hpp>
 #include <ustore/cpp/types.hpp>
@@ -13,6 +21,7 @@
 #include "src/core/db.hpp"
 #include "src/core/helper.hpp"
 #include "src/core/types.hpp"
+#include "src/core/per_thread.hpp"
 
 #include "ustore_transaction.hpp"
 
@@ -33,13 +42,82 @@ using operation_result_t = ucsb::operation_result_t;
 using db_hints_t = ucsb::db_hints_t;
 using transaction_t = ucsb::transaction_t;
 
+/**
+ * @brief A connection of a benchmark thread.
+ * Pipelined range selects scan through `scan_db` on a sibling thread, which for
+ * the Flight client is a separate connection, as those can't be shared between threads.
+ * Embedded engines have a single handle, already shared by all threads.
+ */
 struct client_t {
     ustore_database_t db = nullptr;
+    ustore_database_t scan_db = nullptr;
     ustore_arena_t memory = nullptr;
 
     operator bool() const noexcept { return db != nullptr; }
 };
 
+/*
+ * @brief Preallocated buffer used for pipelined range selects.
+ * Globals and especially `thread_local`s are a bad practice.
+ */
+thread_local std::vector<ustore_key_t> range_keys;
+thread_local std::string doc_field_path;
+thread_local std::string doc_patch;
+
+/**
+ * @brief Scans the next chunk of a range on a sibling thread, while the caller
+ * reads the values of the current one, so that round trips of both overlap.
+ * Has its own arena, as those can't be shared between threads, and scans
+ * through the `client_t::scan_db` of the caller.
+ */
+class scan_prefetcher_t {
+  public:
+    ~scan_prefetcher_t();
+
+    void submit(ustore_database_t db,
+                ustore_collection_t collection,
+                ustore_options_t options,
+                ustore_key_t start_key,
+                ustore_length_t limit);
+    /**
+     * @brief Blocks until the submitted scan is done and swaps the found keys into `keys`.
+     */
+    bool wait(std::vector<ustore_key_t>& keys, size_t& scan_ns);
+
+  private:
+    enum class state_t { idle_k, submitted_k, done_k, stopped_k };
+    struct task_t {
+        ustore_database_t db = nullptr;
+        ustore_collection_t collection = ustore_collection_main_k;
+        ustore_options_t options = ustore_options_default_k;
+        ustore_key_t start_key = 0;
+        ustore_length_t limit = 0;
+    };
+
+    void run();
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    state_t state_ = state_t::idle_k;
+    task_t task_;
+    std::vector<ustore_key_t> keys_;
+    bool ok_ = false;
+    size_t scan_ns_ = 0;
+    ustore_arena_t arena_ = nullptr;
+};
+
+/**
+ * @brief Time spent in each stage of range selects, shared by all threads.
+ * In the pipelined mode scans run concurrently with reads, so stages overlap.
+ */
+struct range_select_stats_t {
+    std::atomic<size_t> selects = 0;
+    std::atomic<size_t> scan_ns = 0;
+    std::atomic<size_t> read_ns = 0;
+    std::atomic<size_t> total_ns = 0;
+};
+
 class ustore_t : public ucsb::db_t {
   public:
     inline ustore_t() = default;
@@ -67,15 +145,24 @@ class ustore_t : public ucsb::db_t {
     operation_result_t range_select(key_t key, size_t length, values_span_t values) const override;
     operation_result_t scan(key_t key, size_t length, value_span_t single_value) const override;
 
+    operation_result_t read_field(key_t key, std::string_view field, value_span_t value) const override;
+    operation_result_t patch_field(key_t key, std::string_view field, value_spanc_t value) override;
+    operation_result_t upsert_edge(key_t source, key_t target) override;
+    operation_result_t read_neighbors(key_t vertex) const override;
+
     void flush() override;
 
     size_t size_on_disk() const override;
+    db_counters_t counters() override;
 
     std::unique_ptr<transaction_t> create_transaction() override;
 
   private:
     void free();
     inline void map_client() const;
+    bool open_collection(char const* name, ustore_collection_t& collection, std::string& error);
+    void load_benchmark_options(nlohmann::json const& j_config);
+    operation_result_t range_select_pipelined(key_t key, size_t length, values_span_t values) const;
 
     fs::path config_path_;
     fs::path main_dir_path_;
@@ -86,12 +173,95 @@ class ustore_t : public ucsb::db_t {
     static thread_local client_t client_;
     static std::atomic_size_t client_index_;
     ustore_collection_t collection_ = ustore_collection_main_k;
+    ustore_collection_t docs_collection_ = ustore_collection_main_k;
+    ustore_collection_t graph_collection_ = ustore_collection_main_k;
     ustore_options_t options_ = ustore_options_default_k;
+
+    bool range_select_pipelined_ = false;
+    size_t range_select_chunk_ = 256;
+    mutable per_thread_t<scan_prefetcher_t> prefetchers_;
+    mutable range_select_stats_t range_select_stats_;
 };
 
 thread_local client_t ustore_t::client_;
 std::atomic_size_t ustore_t::client_index_ = 0;
 
+scan_prefetcher_t::~scan_prefetcher_t() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            state_ = state_t::stopped_k;
+        }
+        condition_.notify_all();
+        thread_.join();
+    }
+    ustore_arena_free(arena_);
+}
+
+void scan_prefetcher_t::submit(ustore_database_t db,
+                               ustore_collection_t collection,
+                               ustore_options_t options,
+                               ustore_key_t start_key,
+                               ustore_length_t limit) {
+    if (!thread_.joinable())
+        thread_ = std::thread(&scan_prefetcher_t::run, this);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = {db, collection, options, start_key, limit};
+        state_ = state_t::submitted_k;
+    }
+    condition_.notify_all();
+}
+
+bool scan_prefetcher_t::wait(std::vector<ustore_key_t>& keys, size_t& scan_ns) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [&] { return state_ == state_t::done_k; });
+    state_ = state_t::idle_k;
+    keys.swap(keys_);
+    scan_ns = scan_ns_;
+    return ok_;
+}
+
+void scan_prefetcher_t::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        condition_.wait(lock, [&] { return state_ == state_t::submitted_k || state_ == state_t::stopped_k; });
+        if (state_ == state_t::stopped_k)
+            return;
+        task_t task = task_;
+        lock.unlock();
+
+        ustore::status_t status;
+        ustore_length_t* found_counts = nullptr;
+        ustore_key_t* found_keys = nullptr;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        ustore_scan_t scan {};
+        scan.db = task.db;
+        scan.error = status.member_ptr();
+        scan.arena = &arena_;
+        scan.options = task.options;
+        scan.tasks_count = 1;
+        scan.collections = &task.collection;
+        scan.start_keys = &task.start_key;
+        scan.count_limits = &task.limit;
+        scan.counts = &found_counts;
+        scan.keys = &found_keys;
+        ustore_scan(&scan);
+        auto elapsed_time = std::chrono::high_resolution_clock::now() - start_time;
+
+        lock.lock();
+        ok_ = bool(status);
+        if (ok_)
+            keys_.assign(found_keys, found_keys + *found_counts);
+        else
+            keys_.clear();
+        scan_ns_ = std::chrono::nanoseconds(elapsed_time).count();
+        state_ = state_t::done_k;
+        condition_.notify_all();
+    }
+}
+
 void ustore_t::set_config(fs::path const& config_path,
                           fs::path const& main_dir_path,
                           std::vector<fs::path> const& storage_dir_paths,
@@ -114,6 +284,14 @@ bool ustore_t::open(std::string& error) {
     }
     std::string str_config((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
 
+    // Settings of the benchmark itself are cut out, before UStore sees the config
+    auto j_config = nlohmann::json::parse(str_config, nullptr, false, true);
+    if (!j_config.is_discarded() && j_config.contains("ucsb")) {
+        load_benchmark_options(j_config["ucsb"]);
+        j_config.erase("ucsb");
+        str_config = j_config.dump();
+    }
+
     // Load and overwrite
     ustore::config_t config;
     auto status = ustore::config_loader_t::load_from_json_string(str_config, config, true);
@@ -179,11 +357,78 @@ bool ustore_t::open(std::string& error) {
             error = status.message();
             return status;
         }
+        clients_[i].scan_db = clients_[i].db;
+#if defined(USTORE_ENGINE_IS_FLIGHT_CLIENT)
+        if (range_select_pipelined_) {
+            init.db = &clients_[i].scan_db;
+            ustore_database_init(&init);
+            if (!status) {
+                error = status.message();
+                return status;
+            }
+        }
+#endif
+    }
+
+    // Documents and graphs live in named collections next to the main one
+    return open_collection("ucsb.docs", docs_collection_, error) &&
+           open_collection("ucsb.graph", graph_collection_, error);
+}
+
+bool ustore_t::open_collection(char const* name, ustore_collection_t& collection, std::string& error) {
+    ustore::status_t status;
+    ustore_arena_t arena = nullptr;
+    ustore_size_t count = 0;
+    ustore_collection_t* ids = nullptr;
+    ustore_length_t* offsets = nullptr;
+    ustore_char_t* names = nullptr;
+
+    ustore_collection_list_t list {};
+    list.db = clients_.front().db;
+    list.error = status.member_ptr();
+    list.arena = &arena;
+    list.count = &count;
+    list.ids = &ids;
+    list.offsets = &offsets;
+    list.names = &names;
+    ustore_collection_list(&list);
+    if (!status) {
+        ustore_arena_free(arena);
+        error = status.message();
+        return false;
+    }
+
+    for (ustore_size_t idx = 0; idx != count; ++idx) {
+        if (std::strcmp(names + offsets[idx], name) == 0) {
+            collection = ids[idx];
+            ustore_arena_free(arena);
+            return true;
+        }
+    }
+    ustore_arena_free(arena);
+
+    ustore_collection_create_t create {};
+    create.db = clients_.front().db;
+    create.error = status.member_ptr();
+    create.name = name;
+    create.config = "";
+    create.id = &collection;
+    ustore_collection_create(&create);
+    if (!status) {
+        error = status.message();
+        return false;
     }
     return true;
 }
 
+void ustore_t::load_benchmark_options(nlohmann::json const& j_config) {
+    auto j_range_select = j_config.value("range_select", nlohmann::json::object());
+    range_select_pipelined_ = j_range_select.value("pipelined", range_select_pipelined_);
+    range_select_chunk_ = std::max(j_range_select.value("chunk", range_select_chunk_), size_t(1));
+}
+
 void ustore_t::close() {
+    prefetchers_.clear();
     client_index_.store(0);
 #if !defined(USTORE_ENGINE_IS_UCSET)
     free();
@@ -193,10 +438,13 @@ void ustore_t::close() {
 void ustore_t::free() {
     for (std::size_t i = 0; i < clients_.size(); ++i) {
         ustore_arena_free(clients_[i].memory);
+        if (clients_[i].scan_db != clients_[i].db)
+            ustore_database_free(clients_[i].scan_db);
         ustore_database_free(clients_[i].db);
     }
     clients_.clear();
     client_.db = nullptr;
+    client_.scan_db = nullptr;
     client_.memory = nullptr;
 }
 
@@ -299,7 +547,8 @@ operation_result_t ustore_t::read(key_t key, value_span_t value) const {
     if (lengths[0] == ustore_length_missing_k)
         return {0, operation_status_t::not_found_k};
 
-    memcpy(value.data(), value_, lengths[0]);
+    if (!export_value(value_, lengths[0], value))
+        return {0, operation_status_t::error_k};
     return {1, operation_status_t::ok_k};
 }
 
@@ -307,12 +556,6 @@ operation_result_t ustore_t::batch_upsert(keys_spanc_t keys, values_spanc_t valu
     map_client();
 
     ustore::status_t status;
-    std::vector<ustore_length_t> offsets;
-    offsets.reserve(sizes.size() + 1);
-    offsets.push_back(0);
-    for (auto size : sizes)
-        offsets.push_back(offsets.back() + size);
-
     auto values_ = make_value(values.data(), values.size());
     ustore_write_t write {};
     write.db = client_.db;
@@ -323,7 +566,7 @@ operation_result_t ustore_t::batch_upsert(keys_spanc_t keys, values_spanc_t valu
     write.collections = &collection_;
     write.keys = reinterpret_cast<ustore_key_t const*>(keys.data());
     write.keys_stride = sizeof(ustore_key_t);
-    write.offsets = offsets.data();
+    write.offsets = make_offsets(sizes);
     write.offsets_stride = sizeof(ustore_length_t);
     write.lengths = reinterpret_cast<ustore_length_t const*>(sizes.data());
     write.lengths_stride = sizeof(ustore_length_t);
@@ -364,7 +607,8 @@ operation_result_t ustore_t::batch_read(keys_spanc_t keys, values_span_t values)
     for (size_t idx = 0; idx < keys.size(); ++idx) {
         if (lengths[idx] == ustore_length_missing_k)
             continue;
-        memcpy(values.data() + offset, values_ + offsets[idx], lengths[idx]);
+        if (!export_value(values_ + offsets[idx], lengths[idx], values.subspan(offset)))
+            return {found_cnt, operation_status_t::error_k};
         offset += lengths[idx];
         ++found_cnt;
     }
@@ -378,6 +622,8 @@ operation_result_t ustore_t::bulk_load(keys_spanc_t keys, values_spanc_t values,
 
 operation_result_t ustore_t::range_select(key_t key, size_t length, values_span_t values) const {
     map_client();
+    if (range_select_pipelined_)
+        return range_select_pipelined(key, length, values);
 
     ustore::status_t status;
     ustore_key_t key_ = key;
@@ -386,6 +632,7 @@ operation_result_t ustore_t::range_select(key_t key, size_t length, values_span_
     ustore_key_t* found_keys = nullptr;
 
     // First scan keys
+    auto start_time = std::chrono::high_resolution_clock::now();
     ustore_scan_t scan {};
     scan.db = client_.db;
     scan.error = status.member_ptr();
@@ -406,6 +653,7 @@ operation_result_t ustore_t::range_select(key_t key, size_t length, values_span_
     ustore_byte_t* values_ = nullptr;
 
     // Then do batch read
+    auto read_start_time = std::chrono::high_resolution_clock::now();
     ustore_read_t read {};
     read.db = client_.db;
     read.error = status.member_ptr();
@@ -421,18 +669,117 @@ operation_result_t ustore_t::range_select(key_t key, size_t length, values_span_
     ustore_read(&read);
     if (!status)
         return {0, operation_status_t::error_k};
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    range_select_stats_.selects += 1;
+    range_select_stats_.scan_ns += std::chrono::nanoseconds(read_start_time - start_time).count();
+    range_select_stats_.read_ns += std::chrono::nanoseconds(end_time - read_start_time).count();
+    range_select_stats_.total_ns += std::chrono::nanoseconds(end_time - start_time).count();
 
     size_t offset = 0;
     for (size_t idx = 0; idx < *found_counts; ++idx) {
         if (lengths[idx] == ustore_length_missing_k)
             continue;
-        memcpy(values.data() + offset, values_ + offsets[idx], lengths[idx]);
+        if (!export_value(values_ + offsets[idx], lengths[idx], values.subspan(offset)))
+            return {idx, operation_status_t::error_k};
         offset += lengths[idx];
     }
 
     return {*found_counts, *found_counts > 0 ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
+/**
+ * @brief UStore has no scan returning values, so the range is split into chunks
+ * and the scan of the next chunk is done by a prefetcher, while values of the
+ * current one are being read. Every chunk starts right after the last key of the previous.
+ */
+operation_result_t ustore_t::range_select_pipelined(key_t key, size_t length, values_span_t values) const {
+    scan_prefetcher_t& prefetcher = prefetchers_.local();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    size_t chunk = std::min(range_select_chunk_, length);
+    prefetcher.submit(client_.scan_db, collection_, options_, key, chunk);
+
+    ustore::status_t status;
+    ustore_length_t* offsets = nullptr;
+    ustore_length_t* lengths = nullptr;
+    ustore_byte_t* values_ = nullptr;
+
+    ustore_read_t read {};
+    read.db = client_.db;
+    read.error = status.member_ptr();
+    read.arena = &client_.memory;
+    read.options = options_;
+    read.collections = &collection_;
+    read.keys_stride = sizeof(ustore_key_t);
+    read.offsets = &offsets;
+    read.lengths = &lengths;
+    read.values = &values_;
+
+    size_t selected = 0;
+    size_t offset = 0;
+    size_t scan_ns = 0;
+    size_t read_ns = 0;
+    bool pending = true;
+    bool failed = false;
+    while (pending) {
+        size_t chunk_scan_ns = 0;
+        pending = false;
+        if (!prefetcher.wait(range_keys, chunk_scan_ns)) {
+            failed = true;
+            break;
+        }
+        scan_ns += chunk_scan_ns;
+
+        // A short chunk means the end of the collection
+        size_t remaining = length - selected - range_keys.size();
+        if (range_keys.size() == chunk && remaining) {
+            chunk = std::min(range_select_chunk_, remaining);
+            prefetcher.submit(client_.scan_db, collection_, options_, range_keys.back() + 1, chunk);
+            pending = true;
+        }
+        if (range_keys.empty())
+            break;
+
+        auto read_start_time = std::chrono::high_resolution_clock::now();
+        read.tasks_count = range_keys.size();
+        read.keys = range_keys.data();
+        ustore_read(&read);
+        read_ns += std::chrono::nanoseconds(std::chrono::high_resolution_clock::now() - read_start_time).count();
+        if (!status) {
+            failed = true;
+            break;
+        }
+
+        for (size_t idx = 0; idx < range_keys.size(); ++idx) {
+            if (lengths[idx] == ustore_length_missing_k)
+                continue;
+            if (!export_value(values_ + offsets[idx], lengths[idx], values.subspan(offset))) {
+                failed = true;
+                break;
+            }
+            offset += lengths[idx];
+        }
+        if (failed)
+            break;
+        selected += range_keys.size();
+    }
+
+    // The prefetcher must be idle, before the next call
+    if (pending) {
+        size_t chunk_scan_ns = 0;
+        prefetcher.wait(range_keys, chunk_scan_ns);
+    }
+    if (failed)
+        return {selected, operation_status_t::error_k};
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    range_select_stats_.selects += 1;
+    range_select_stats_.scan_ns += scan_ns;
+    range_select_stats_.read_ns += read_ns;
+    range_select_stats_.total_ns += std::chrono::nanoseconds(end_time - start_time).count();
+    return {selected, selected > 0 ? operation_status_t::ok_k : operation_status_t::not_found_k};
+}
+
 operation_result_t ustore_t::scan(key_t key, size_t length, value_span_t single_value) const {
     map_client();
 
@@ -490,7 +837,7 @@ operation_result_t ustore_t::scan(key_t key, size_t length, value_span_t single_
         scanned += *found_counts;
         for (size_t idx = 0; idx < *found_counts; ++idx)
             if (lengths[idx] != ustore_length_missing_k)
-                memcpy(single_value.data(), values_ + offsets[idx], lengths[idx]);
+                export_value(values_ + offsets[idx], lengths[idx], single_value);
 
         key_ += len;
         remaining_keys_cnt = remaining_keys_cnt - len;
@@ -500,6 +847,123 @@ operation_result_t ustore_t::scan(key_t key, size_t length, value_span_t single_
     return {scanned, scanned > 0 ? operation_status_t::ok_k : operation_status_t::not_found_k};
 }
 
+operation_result_t ustore_t::read_field(key_t key, std::string_view field, value_span_t value) const {
+    map_client();
+
+    ustore::status_t status;
+    ustore_key_t key_ = key;
+    doc_field_path.assign("/").append(field);
+    ustore_str_view_t field_ = doc_field_path.c_str();
+    ustore_byte_t* value_ = nullptr;
+    ustore_length_t* lengths = nullptr;
+
+    ustore_docs_read_t docs_read {};
+    docs_read.db = client_.db;
+    docs_read.error = status.member_ptr();
+    docs_read.arena = &client_.memory;
+    docs_read.options = options_;
+    docs_read.type = ustore_doc_field_str_k;
+    docs_read.tasks_count = 1;
+    docs_read.collections = &docs_collection_;
+    docs_read.keys = &key_;
+    docs_read.fields = &field_;
+    docs_read.lengths = &lengths;
+    docs_read.values = &value_;
+    ustore_docs_read(&docs_read);
+    if (!status)
+        return {0, operation_status_t::error_k};
+    if (lengths[0] == ustore_length_missing_k)
+        return {0, operation_status_t::not_found_k};
+
+    // Strings may come with a terminating null, which doesn't fit into a full-sized buffer
+    ustore_length_t length = std::min<ustore_length_t>(lengths[0], value.size());
+    export_value(value_, length, value);
+    return {1, operation_status_t::ok_k};
+}
+
+operation_result_t ustore_t::patch_field(key_t key, std::string_view field, value_spanc_t value) {
+    map_client();
+
+    // Random bytes are mapped to letters, so the value needs no escaping
+    doc_patch.assign("{\"").append(field).append("\":\"");
+    for (auto byte : value)
+        doc_patch.push_back(char('a' + size_t(byte) % 26));
+    doc_patch.append("\"}");
+
+    ustore::status_t status;
+    ustore_key_t key_ = key;
+    ustore_length_t length = doc_patch.size();
+    auto value_ = reinterpret_cast<ustore_bytes_cptr_t>(doc_patch.data());
+
+    ustore_docs_write_t docs_write {};
+    docs_write.db = client_.db;
+    docs_write.error = status.member_ptr();
+    docs_write.arena = &client_.memory;
+    docs_write.options = options_;
+    docs_write.tasks_count = 1;
+    docs_write.type = ustore_doc_field_json_k;
+    docs_write.modification = ustore_doc_modify_merge_k;
+    docs_write.collections = &docs_collection_;
+    docs_write.keys = &key_;
+    docs_write.lengths = &length;
+    docs_write.values = &value_;
+    ustore_docs_write(&docs_write);
+
+    return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t ustore_t::upsert_edge(key_t source, key_t target) {
+    map_client();
+
+    ustore::status_t status;
+    ustore_key_t source_ = source;
+    ustore_key_t target_ = target;
+    ustore_key_t edge_ = ustore_default_edge_id_k;
+
+    ustore_graph_upsert_edges_t upsert {};
+    upsert.db = client_.db;
+    upsert.error = status.member_ptr();
+    upsert.arena = &client_.memory;
+    upsert.options = options_;
+    upsert.tasks_count = 1;
+    upsert.collections = &graph_collection_;
+    upsert.edges_ids = &edge_;
+    upsert.sources_ids = &source_;
+    upsert.targets_ids = &target_;
+    ustore_graph_upsert_edges(&upsert);
+
+    return {size_t(status), status ? operation_status_t::ok_k : operation_status_t::error_k};
+}
+
+operation_result_t ustore_t::read_neighbors(key_t vertex) const {
+    map_client();
+
+    ustore::status_t status;
+    ustore_key_t vertex_ = vertex;
+    ustore_vertex_role_t role = ustore_vertex_role_any_k;
+    ustore_vertex_degree_t* degrees = nullptr;
+    ustore_key_t* edges = nullptr;
+
+    ustore_graph_find_edges_t find {};
+    find.db = client_.db;
+    find.error = status.member_ptr();
+    find.arena = &client_.memory;
+    find.options = options_;
+    find.tasks_count = 1;
+    find.collections = &graph_collection_;
+    find.vertices = &vertex_;
+    find.roles = &role;
+    find.degrees_per_vertex = &degrees;
+    find.edges_per_vertex = &edges;
+    ustore_graph_find_edges(&find);
+    if (!status)
+        return {0, operation_status_t::error_k};
+    if (degrees[0] == ustore_vertex_degree_missing_k)
+        return {0, operation_status_t::not_found_k};
+
+    return {degrees[0], operation_status_t::ok_k};
+}
+
 std::string ustore_t::info() { return fmt::format("v{}, {}", USTORE_VERSION, USTORE_ENGINE_NAME); }
 
 void ustore_t::flush() {
@@ -529,6 +993,21 @@ size_t ustore_t::size_on_disk() const {
     return files_size;
 }
 
+db_counters_t ustore_t::counters() {
+    db_counters_t counters;
+    size_t selects = range_select_stats_.selects.exchange(0);
+    size_t scan_ns = range_select_stats_.scan_ns.exchange(0);
+    size_t read_ns = range_select_stats_.read_ns.exchange(0);
+    size_t total_ns = range_select_stats_.total_ns.exchange(0);
+    if (!selects)
+        return counters;
+
+    counters["range_select_scan,us"] = scan_ns / 1e3 / selects;
+    counters["range_select_read,us"] = read_ns / 1e3 / selects;
+    counters["range_select_latency,us"] = total_ns / 1e3 / selects;
+    return counters;
+}
+
 std::unique_ptr<transaction_t> ustore_t::create_transaction() {
     map_client();
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <cstring>
+
 #include <ustore/db.h>
 #include <ustore/cpp/status.hpp>
 
@@ -23,10 +26,38 @@ using operation_result_t = ucsb::operation_result_t;
 
 thread_local ustore::arena_t arena_(nullptr);
 
+/*
+ * @brief Preallocated buffer for offsets of batch writes, reused across calls.
+ * Globals and especially `thread_local`s are a bad practice.
+ */
+thread_local std::vector<ustore_length_t> batch_offsets;
+
 inline ustore::value_view_t make_value(std::byte const* ptr, size_t length) {
     return {reinterpret_cast<ustore_bytes_cptr_t>(ptr), static_cast<ustore_length_t>(length)};
 }
 
+inline ustore_length_t const* make_offsets(value_lengths_spanc_t sizes) {
+    batch_offsets.resize(sizes.size() + 1);
+    batch_offsets[0] = 0;
+    for (size_t idx = 0; idx != sizes.size(); ++idx)
+        batch_offsets[idx + 1] = batch_offsets[idx] + sizes[idx];
+    return batch_offsets.data();
+}
+
+/**
+ * @brief Exports a value, found in the arena, into the UCSB buffer.
+ * With `UCSB_USTORE_ZERO_COPY` the value is consumed in place, as the arena
+ * outlives the operation: it is only validated to fit the buffer, but never copied.
+ */
+inline bool export_value([[maybe_unused]] ustore_bytes_cptr_t source, ustore_length_t length, value_span_t target) {
+    if (length > target.size())
+        return false;
+#if !defined(UCSB_USTORE_ZERO_COPY)
+    memcpy(target.data(), source, length);
+#endif
+    return true;
+}
+
 class ustore_transact_t : public ucsb::transaction_t {
   public:
     inline ustore_transact_t(ustore_database_t db, ustore_transaction_t transaction)
@@ -164,7 +195,8 @@ operation_result_t ustore_transact_t::read(key_t key, value_span_t value) const
     if (lengths[0] == ustore_length_missing_k)
         return {0, operation_status_t::not_found_k};
 
-    memcpy(value.data(), value_, lengths[0]);
+    if (!export_value(value_, lengths[0], value))
+        return {0, operation_status_t::error_k};
     return {1, operation_status_t::ok_k};
 }
 
@@ -172,12 +204,6 @@ operation_result_t ustore_transact_t::batch_upsert(keys_spanc_t keys,
                                                    values_spanc_t values,
                                                    value_lengths_spanc_t sizes) {
     ustore::status_t status;
-    std::vector<ustore_length_t> offsets;
-    offsets.reserve(sizes.size() + 1);
-    offsets.push_back(0);
-    for (auto size : sizes)
-        offsets.push_back(offsets.back() + size);
-
     auto values_ = make_value(values.data(), values.size());
     ustore_write_t write {};
     write.db = db_;
@@ -189,7 +215,7 @@ operation_result_t ustore_transact_t::batch_upsert(keys_spanc_t keys,
     write.collections = &collection_;
     write.keys = reinterpret_cast<ustore_key_t const*>(keys.data());
     write.keys_stride = sizeof(ustore_key_t);
-    write.offsets = offsets.data();
+    write.offsets = make_offsets(sizes);
     write.offsets_stride = sizeof(ustore_length_t);
     write.lengths = reinterpret_cast<ustore_length_t const*>(sizes.data());
     write.lengths_stride = sizeof(ustore_length_t);
@@ -233,7 +259,8 @@ operation_result_t ustore_transact_t::batch_read(keys_spanc_t keys, values_span_
     for (size_t idx = 0; idx < keys.size(); ++idx) {
         if (lengths[idx] == ustore_length_missing_k)
             continue;
-        memcpy(values.data() + offset, values_ + offsets[idx], lengths[idx]);
+        if (!export_value(values_ + offsets[idx], lengths[idx], values.subspan(offset)))
+            return {found_cnt, operation_status_t::error_k};
         offset += lengths[idx];
         ++found_cnt;
     }
@@ -295,7 +322,8 @@ operation_result_t ustore_transact_t::range_select(key_t key, size_t length, val
     for (size_t idx = 0; idx < *found_counts; ++idx) {
         if (lengths[idx] == ustore_length_missing_k)
             continue;
-        memcpy(values.data() + offset, values_ + offsets[idx], lengths[idx]);
+        if (!export_value(values_ + offsets[idx], lengths[idx], values.subspan(offset)))
+            return {idx, operation_status_t::error_k};
         offset += lengths[idx];
     }
 
@@ -359,7 +387,7 @@ operation_result_t ustore_transact_t::scan(key_t key, size_t length, value_span_
         scanned += *found_counts;
         for (size_t idx = 0; idx < *found_counts; ++idx)
             if (lengths[idx] != ustore_length_missing_k)
-                memcpy(single_value.data(), values_ + offsets[idx], lengths[idx]);
+                export_value(values_ + offsets[idx], lengths[idx], single_value);
 
         key_ += len;
         remaining_keys_cnt = remaining_keys_cnt - len;